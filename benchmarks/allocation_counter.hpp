@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Number of calls to the global operator new since the program started.
+// Benchmarks take the difference around the code they measure.
+uint64_t allocation_count();
@@ -0,0 +1,292 @@
+#include <json_writer.hpp>
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+namespace
+{
+
+const char hex_digits[] = "0123456789ABCDEF";
+
+bool needs_escape(unsigned char byte)
+{
+    return byte < 0x20 || byte == '"' || byte == '\\';
+}
+
+// Finds the first character that has to be escaped, looking at eight of them
+// at a time: a word is skipped when none of its bytes is below 0x20, a quote or
+// a backslash.
+const char* find_escape(const char* begin, const char* end)
+{
+    const uint64_t ones = 0x0101010101010101ull;
+    const uint64_t highs = 0x8080808080808080ull;
+
+    while (end - begin >= 8) {
+        uint64_t word;
+        std::memcpy(&word, begin, sizeof(word));
+
+        const uint64_t control = (word - ones * 0x20) & ~word;
+        const uint64_t quote = ((word ^ (ones * '"')) - ones) & ~(word ^ (ones * '"'));
+        const uint64_t backslash = ((word ^ (ones * '\\')) - ones) & ~(word ^ (ones * '\\'));
+        if ((control | quote | backslash) & highs) {
+            break;
+        }
+        begin += 8;
+    }
+
+    while (begin != end && !needs_escape(static_cast<unsigned char>(*begin))) {
+        ++begin;
+    }
+    return begin;
+}
+
+bool to_local_and_utc(std::time_t time, std::tm& local, std::tm& utc)
+{
+#ifdef _WIN32
+    return localtime_s(&local, &time) == 0 && gmtime_s(&utc, &time) == 0;
+#else
+    return localtime_r(&time, &local) && gmtime_r(&time, &utc);
+#endif
+}
+
+// Formatting a timestamp means looking up the time zone, so the text up to the
+// second is kept and only the fraction is written for every timestamp within
+// that second.
+struct timestamp_cache
+{
+    std::time_t second = -1;
+
+    // "2020-05-09T22:30:58" and "-0500".
+    char date_time[20] = {};
+    char zone[6] = {};
+
+    void update(std::time_t time) {
+        std::tm local = {};
+        std::tm utc = {};
+        if (!to_local_and_utc(time, local, utc)) {
+            local = std::tm();
+            utc = std::tm();
+        }
+
+        std::snprintf(
+            date_time, sizeof(date_time), "%04d-%02d-%02dT%02d:%02d:%02d",
+            local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+            local.tm_hour, local.tm_min, local.tm_sec);
+
+        int days = local.tm_yday - utc.tm_yday;
+        if (local.tm_year != utc.tm_year) {
+            days = local.tm_year < utc.tm_year ? -1 : 1;
+        }
+        const int offset = days * 24 * 60 + (local.tm_hour - utc.tm_hour) * 60 + (local.tm_min - utc.tm_min);
+        const int magnitude = offset < 0 ? -offset : offset;
+        std::snprintf(zone, sizeof(zone), "%c%02d%02d", offset < 0 ? '-' : '+', magnitude / 60, magnitude % 60);
+
+        second = time;
+    }
+};
+
+// The same few uuids, the launch and the running items, are written over and
+// over, so the text of the last few is kept rather than formatted again.
+struct uuid_cache
+{
+    struct entry
+    {
+        uuids::uuid id;
+        std::string text;
+    };
+
+    std::array<entry, 4> entries;
+    std::size_t next = 0;
+
+    const std::string& text(const uuids::uuid& id) {
+        for (const entry& cached : entries) {
+            if (!cached.text.empty() && cached.id == id) {
+                return cached.text;
+            }
+        }
+
+        entry& replaced = entries[next];
+        next = (next + 1) % entries.size();
+        replaced.id = id;
+        replaced.text = uuids::to_string(id);
+        return replaced.text;
+    }
+};
+
+}
+
+json_writer::json_writer(std::string& out)
+  : _out(out)
+{}
+
+void json_writer::begin_object() {
+    separate();
+    _out.push_back('{');
+    ++_depth;
+    _has_value &= ~(uint64_t(1) << (_depth % 64));
+}
+
+void json_writer::end_object() {
+    _out.push_back('}');
+    --_depth;
+}
+
+void json_writer::begin_array() {
+    separate();
+    _out.push_back('[');
+    ++_depth;
+    _has_value &= ~(uint64_t(1) << (_depth % 64));
+}
+
+void json_writer::end_array() {
+    _out.push_back(']');
+    --_depth;
+}
+
+void json_writer::key(std::string_view name) {
+    separate();
+    _out.push_back('"');
+    _out.append(name);
+    _out.append("\":");
+    _after_key = true;
+}
+
+void json_writer::value(std::string_view text) {
+    separate();
+    _out.push_back('"');
+    append_escaped(_out, text);
+    _out.push_back('"');
+}
+
+void json_writer::value(const char* text) {
+    value(std::string_view(text));
+}
+
+void json_writer::value(uint64_t number) {
+    separate();
+    char digits[20];
+    std::size_t length = 0;
+    do {
+        digits[length++] = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+
+    while (length > 0) {
+        _out.push_back(digits[--length]);
+    }
+}
+
+void json_writer::value(bool flag) {
+    separate();
+    _out.append(flag ? "true" : "false");
+}
+
+void json_writer::value(const uuids::uuid& id) {
+    separate();
+    _out.push_back('"');
+    append_uuid(_out, id);
+    _out.push_back('"');
+}
+
+void json_writer::value(std::chrono::system_clock::time_point time) {
+    separate();
+    _out.push_back('"');
+    append_timestamp(_out, time);
+    _out.push_back('"');
+}
+
+void json_writer::separate() {
+    if (_after_key) {
+        _after_key = false;
+        return;
+    }
+
+    const uint64_t bit = uint64_t(1) << (_depth % 64);
+    if (_has_value & bit) {
+        _out.push_back(',');
+    }
+    _has_value |= bit;
+}
+
+void append_escaped(std::string& out, std::string_view text)
+{
+    const char* plain = text.data();
+    const char* const end = text.data() + text.size();
+    for (const char* c = find_escape(plain, end); c != end; c = find_escape(plain, end)) {
+        out.append(plain, c - plain);
+        plain = c + 1;
+
+        const unsigned char byte = static_cast<unsigned char>(*c);
+        out.push_back('\\');
+        switch (byte) {
+            case '"':
+            case '\\':
+                out.push_back(*c);
+                break;
+            case '\b':
+                out.push_back('b');
+                break;
+            case '\f':
+                out.push_back('f');
+                break;
+            case '\n':
+                out.push_back('n');
+                break;
+            case '\r':
+                out.push_back('r');
+                break;
+            case '\t':
+                out.push_back('t');
+                break;
+            default:
+                out.append("u00");
+                out.push_back(hex_digits[byte >> 4]);
+                out.push_back(hex_digits[byte & 0xf]);
+                break;
+        }
+    }
+    out.append(plain, end - plain);
+}
+
+void append_timestamp(std::string& out, std::chrono::system_clock::time_point time)
+{
+    static thread_local timestamp_cache cache;
+
+    const int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+    int64_t seconds = micros / 1000000;
+    int64_t fraction = micros % 1000000;
+    if (fraction < 0) {
+        fraction += 1000000;
+        --seconds;
+    }
+
+    if (cache.second != static_cast<std::time_t>(seconds)) {
+        cache.update(static_cast<std::time_t>(seconds));
+    }
+
+    out.append(cache.date_time, sizeof(cache.date_time) - 1);
+    out.push_back('.');
+    char digits[6];
+    for (int i = 5; i >= 0; --i) {
+        digits[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    out.append(digits, sizeof(digits));
+    out.append(cache.zone, sizeof(cache.zone) - 1);
+}
+
+void append_uuid(std::string& out, const uuids::uuid& id)
+{
+    static thread_local uuid_cache cache;
+    out.append(cache.text(id));
+}
+
+}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <uuid.h>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Streams JSON text onto the end of a string owned by the caller, with no
+// document in between. Keeping that string around and clearing it between
+// requests means writing a request does not allocate once the string has grown
+// to the size of the largest one.
+//
+// The output matches what report_portal::rapidjson_serializer produces: no
+// whitespace, the same string escapes and timestamps in local time as
+// 2020-05-09T22:30:58.000000-0500.
+class json_writer
+{
+    public:
+        explicit json_writer(std::string& out);
+
+        void begin_object();
+        void end_object();
+        void begin_array();
+        void end_array();
+
+        // Writes the key of the next member. Keys are written as given and
+        // must not need escaping.
+        void key(std::string_view name);
+
+        void value(std::string_view text);
+        void value(const char* text);
+        void value(uint64_t number);
+        void value(bool flag);
+        void value(const uuids::uuid& id);
+        void value(std::chrono::system_clock::time_point time);
+
+    private:
+        // Writes the comma in front of anything but the first value of an
+        // array or object.
+        void separate();
+
+        std::string& _out;
+
+        // One bit per nesting level telling whether it has a value already.
+        uint64_t _has_value = 0;
+        unsigned _depth = 0;
+        bool _after_key = false;
+};
+
+// Appends text to out as the contents of a JSON string, escaping what JSON
+// requires.
+void append_escaped(std::string& out, std::string_view text);
+
+// Appends time to out in the format used by ReportPortal requests.
+void append_timestamp(std::string& out, std::chrono::system_clock::time_point time);
+
+// Appends the canonical text form of id to out.
+void append_uuid(std::string& out, const uuids::uuid& id);
+
+}
+}
@@ -0,0 +1,165 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+#include <reportportal/service.hpp>
+
+#include <reportportal/gtest/event_listener.hpp>
+#include <reportportal/gtest/service_reporter.hpp>
+
+#include <allocation_counter.hpp>
+#include <loopback_server.hpp>
+#include <synthetic_tests.hpp>
+
+// Every benchmark runs a synthetic test program of
+// range(0) suites x range(1) tests x range(2) failures per test.
+static void synthetic_shapes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->Args({10, 10, 0});
+    benchmark->Args({10, 100, 0});
+    benchmark->Args({10, 100, 5});
+    benchmark->Args({100, 100, 0});
+    benchmark->Unit(benchmark::kMillisecond);
+}
+
+// Reports per event cost, event rate and allocations per event as counters.
+static void set_event_counters(
+    benchmark::State& state,
+    uint64_t events,
+    uint64_t allocations,
+    std::chrono::nanoseconds elapsed)
+{
+    const double event_count = static_cast<double>(events);
+    state.counters["events"] = benchmark::Counter(event_count, benchmark::Counter::kIsRate);
+    state.counters["ns/event"] = events ? elapsed.count() / event_count : 0.0;
+    state.counters["allocs/event"] = events ? allocations / event_count : 0.0;
+}
+
+// gtest on its own, the baseline the listener benchmarks compare against.
+static void SyntheticRunWithoutListener(benchmark::State& state)
+{
+    const std::string filter = register_synthetic_tests(state.range(0), state.range(1), state.range(2));
+
+    for (auto _ : state) {
+        run_synthetic_tests(filter, nullptr);
+    }
+}
+BENCHMARK(SyntheticRunWithoutListener)->Apply(synthetic_shapes);
+
+// The listener reporting into an in-process reporter that drops every event,
+// i.e. the cost the agent itself adds on the test thread. Only time and
+// allocations inside the listener's callbacks are counted, and the listener is
+// reused across runs so the counters show its steady state, which should not
+// allocate at all.
+static void SyntheticRunWithListener(benchmark::State& state)
+{
+    const std::string filter = register_synthetic_tests(state.range(0), state.range(1), state.range(2));
+
+    auto reporter = std::make_unique<counting_reporter>();
+    counting_reporter& counted = *reporter;
+    reportportal::gtest::event_listener listener(std::move(reporter));
+
+    // Let the listener's buffers grow to their steady state size first.
+    run_synthetic_tests(filter, &listener);
+    counted.events = 0;
+
+    measuring_listener measured(listener);
+    for (auto _ : state) {
+        run_synthetic_tests(filter, &measured);
+    }
+
+    set_event_counters(state, counted.events, measured.allocations, measured.elapsed);
+}
+BENCHMARK(SyntheticRunWithListener)->Apply(synthetic_shapes);
+
+// The whole path down to HTTP requests against a server on the loopback
+// interface.
+static void SyntheticRunAgainstLoopbackServer(benchmark::State& state)
+{
+    const std::string filter = register_synthetic_tests(state.range(0), state.range(1), state.range(2));
+
+    loopback_server server;
+    report_portal::service service(server.url(), "benchmark", "default", "password");
+
+    uint64_t requests_before = server.requests();
+    uint64_t allocations = 0;
+    std::chrono::nanoseconds elapsed(0);
+    for (auto _ : state) {
+        reportportal::gtest::event_listener listener(service);
+
+        const uint64_t allocations_before = allocation_count();
+        const auto start = std::chrono::steady_clock::now();
+        run_synthetic_tests(filter, &listener);
+        elapsed += std::chrono::steady_clock::now() - start;
+        allocations += allocation_count() - allocations_before;
+    }
+
+    set_event_counters(state, server.requests() - requests_before, allocations, elapsed);
+    state.counters["connections"] = static_cast<double>(server.accepted_connections());
+}
+BENCHMARK(SyntheticRunAgainstLoopbackServer)->Apply(synthetic_shapes);
+
+// How well the service reuses its connections when the server drops ones
+// idle for range(0) milliseconds (zero never does). New connections per
+// request is what connection setup, and on TLS endpoints the handshake, costs
+// the run.
+static void SyntheticRunConnectionReuse(benchmark::State& state)
+{
+    const std::string filter = register_synthetic_tests(10, 100, 0);
+
+    loopback_server server{std::chrono::milliseconds(state.range(0))};
+    report_portal::service service(server.url(), "benchmark", "default", "password");
+
+    const uint64_t requests_before = server.requests();
+    const uint64_t connections_before = server.accepted_connections();
+    for (auto _ : state) {
+        reportportal::gtest::event_listener listener(service);
+        run_synthetic_tests(filter, &listener);
+    }
+
+    const double requests = static_cast<double>(server.requests() - requests_before);
+    const double connections = static_cast<double>(server.accepted_connections() - connections_before);
+    state.counters["requests"] = requests;
+    state.counters["connections"] = connections;
+    state.counters["requests/connection"] = connections ? requests / connections : 0.0;
+    state.counters["pipelined"] = static_cast<double>(server.pipelined_requests());
+    state.counters["idle_closes"] = static_cast<double>(server.idle_closes());
+}
+BENCHMARK(SyntheticRunConnectionReuse)
+    ->Arg(0)
+    ->Arg(5)
+    ->Arg(100)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// The loopback run with suites reported from range(3) sender threads, to see
+// how throughput scales with the size of the sender pool. The server takes a
+// millisecond per response, as a remote one would, which is what the pool has
+// to hide. Requests only overlap when range(4) sets concurrent_requests; with
+// it clear the threads take turns on the service and the pool should not
+// scale.
+static void SyntheticRunWithSenderPool(benchmark::State& state)
+{
+    const std::string filter = register_synthetic_tests(state.range(0), state.range(1), state.range(2));
+
+    loopback_server server{std::chrono::milliseconds(0), std::chrono::milliseconds(1)};
+    report_portal::service service(server.url(), "benchmark", "default", "password");
+
+    reportportal::gtest::listener_options options;
+    options.sender_threads = static_cast<std::size_t>(state.range(3));
+    options.concurrent_requests = state.range(4) != 0;
+
+    uint64_t requests_before = server.requests();
+    for (auto _ : state) {
+        reportportal::gtest::event_listener listener(service, options);
+        run_synthetic_tests(filter, &listener);
+    }
+
+    const double requests = static_cast<double>(server.requests() - requests_before);
+    state.counters["requests"] = benchmark::Counter(requests, benchmark::Counter::kIsRate);
+    state.counters["connections"] = static_cast<double>(server.accepted_connections());
+}
+BENCHMARK(SyntheticRunWithSenderPool)
+    ->ArgsProduct({{20}, {20}, {0}, {1, 2, 4, 8}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
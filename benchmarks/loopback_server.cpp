@@ -0,0 +1,257 @@
+#include <loopback_server.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static const char* const uuid_value = "039eda00-b397-4a6b-bab1-b1a9a90376d1";
+
+static std::string lowercase(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return value;
+}
+
+static std::string header_value(const std::string& headers, const std::string& name)
+{
+    const std::string lowered = lowercase(headers);
+    const std::size_t start = lowered.find("\r\n" + name + ":");
+    if (start == std::string::npos) {
+        return "";
+    }
+
+    std::size_t value_start = start + name.size() + 3;
+    const std::size_t value_end = headers.find("\r\n", value_start);
+    while (value_start < value_end && headers[value_start] == ' ') {
+        ++value_start;
+    }
+
+    return lowercase(headers.substr(value_start, value_end - value_start));
+}
+
+// Picks a body the client's deserializers accept for the given request.
+static std::string responce_body(const std::string& method, const std::string& path)
+{
+    const std::string id = std::string("\"id\":\"") + uuid_value + "\"";
+    if (path.find("/oauth/token") != std::string::npos) {
+        return "{\"access_token\":\"token\",\"token_type\":\"bearer\",\"refresh_token\":\"token\",\"expires_in\":3600,\"scope\":\"ui\",\"jti\":\"jti\"}";
+    } else if (path.find("apitoken") != std::string::npos) {
+        return std::string("{\"access_token\":\"") + uuid_value + "\",\"token_type\":\"bearer\",\"scope\":\"api\"}";
+    } else if (path.find("/launch") != std::string::npos) {
+        if (method == "PUT") {
+            return "{" + id + ",\"number\":1,\"link\":\"http://127.0.0.1/launch\"}";
+        }
+        return "{" + id + ",\"number\":1}";
+    } else if (path.find("/item") != std::string::npos && method == "PUT") {
+        return "{\"message\":\"TestItem successfully finished.\"}";
+    }
+
+    return "{" + id + "}";
+}
+
+loopback_server::loopback_server(std::chrono::milliseconds idle_timeout, std::chrono::microseconds response_delay)
+  : _idle_timeout(idle_timeout),
+    _response_delay(response_delay)
+{
+    _listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (_listener < 0) {
+        throw std::runtime_error("Unable to create loopback socket");
+    }
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+
+    socklen_t length = sizeof(address);
+    if (::bind(_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(_listener, 64) != 0
+        || ::getsockname(_listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        ::close(_listener);
+        throw std::runtime_error("Unable to listen on the loopback interface");
+    }
+
+    _port = ntohs(address.sin_port);
+    _acceptor = std::thread(&loopback_server::accept_connections, this);
+}
+
+loopback_server::~loopback_server() {
+    _stopping = true;
+    ::shutdown(_listener, SHUT_RDWR);
+    ::close(_listener);
+    _acceptor.join();
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (int connection : _connections) {
+            ::shutdown(connection, SHUT_RDWR);
+        }
+    }
+
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+std::string loopback_server::url() const {
+    return "http://127.0.0.1:" + std::to_string(_port);
+}
+
+uint64_t loopback_server::accepted_connections() const {
+    return _accepted_connections;
+}
+
+uint64_t loopback_server::requests() const {
+    return _requests;
+}
+
+uint64_t loopback_server::bytes_received() const {
+    return _bytes_received;
+}
+
+uint64_t loopback_server::pipelined_requests() const {
+    return _pipelined_requests;
+}
+
+uint64_t loopback_server::idle_closes() const {
+    return _idle_closes;
+}
+
+void loopback_server::accept_connections() {
+    while (!_stopping) {
+        const int connection = ::accept(_listener, nullptr, nullptr);
+        if (connection < 0) {
+            continue;
+        }
+
+        ++_accepted_connections;
+
+        if (_idle_timeout.count() > 0) {
+            // The timeout applies to every read, which is close enough for
+            // clients that send a request in one go.
+            timeval timeout;
+            timeout.tv_sec = static_cast<time_t>(_idle_timeout.count() / 1000);
+            timeout.tv_usec = static_cast<suseconds_t>((_idle_timeout.count() % 1000) * 1000);
+            ::setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stopping) {
+            ::close(connection);
+            return;
+        }
+        _connections.push_back(connection);
+        _workers.emplace_back(&loopback_server::serve, this, connection);
+    }
+}
+
+void loopback_server::serve(int connection) {
+    exchange(connection);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _connections.erase(std::find(_connections.begin(), _connections.end(), connection));
+    ::close(connection);
+}
+
+void loopback_server::exchange(int connection) {
+    std::string buffer;
+    char chunk[16 * 1024];
+
+    // Reads until buffer holds at least size bytes.
+    auto fill = [&](std::size_t size) {
+        while (buffer.size() < size) {
+            const ssize_t received = ::recv(connection, chunk, sizeof(chunk), 0);
+            if (received <= 0) {
+                if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    ++_idle_closes;
+                }
+                return false;
+            }
+            _bytes_received += received;
+            buffer.append(chunk, received);
+        }
+        return true;
+    };
+
+    while (!_stopping) {
+        std::size_t header_end = buffer.find("\r\n\r\n");
+        while (header_end == std::string::npos) {
+            if (!fill(buffer.size() + 1)) {
+                return;
+            }
+            header_end = buffer.find("\r\n\r\n");
+        }
+
+        const std::string headers = buffer.substr(0, header_end + 2);
+        buffer.erase(0, header_end + 4);
+
+        const std::size_t method_end = headers.find(' ');
+        const std::string method = headers.substr(0, method_end);
+        const std::string path = headers.substr(method_end + 1, headers.find(' ', method_end + 1) - method_end - 1);
+
+        if (header_value(headers, "expect") == "100-continue") {
+            const std::string go_on = "HTTP/1.1 100 Continue\r\n\r\n";
+            ::send(connection, go_on.data(), go_on.size(), MSG_NOSIGNAL);
+        }
+
+        if (header_value(headers, "transfer-encoding") == "chunked") {
+            while (true) {
+                std::size_t line_end = buffer.find("\r\n");
+                while (line_end == std::string::npos) {
+                    if (!fill(buffer.size() + 1)) {
+                        return;
+                    }
+                    line_end = buffer.find("\r\n");
+                }
+
+                const std::size_t size = std::stoul(buffer.substr(0, line_end), nullptr, 16);
+                if (!fill(line_end + 2 + size + 2)) {
+                    return;
+                }
+                buffer.erase(0, line_end + 2 + size + 2);
+                if (size == 0) {
+                    break;
+                }
+            }
+        } else {
+            const std::string content_length = header_value(headers, "content-length");
+            const std::size_t size = content_length.empty() ? 0 : std::stoul(content_length);
+            if (!fill(size)) {
+                return;
+            }
+            buffer.erase(0, size);
+        }
+
+        ++_requests;
+
+        if (_response_delay.count() > 0) {
+            std::this_thread::sleep_for(_response_delay);
+        }
+
+        const std::string body = responce_body(method, path);
+        const std::string responce =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: application/json\r\n"
+            "Connection: keep-alive\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "\r\n" + body;
+        if (::send(connection, responce.data(), responce.size(), MSG_NOSIGNAL) < 0) {
+            return;
+        }
+
+        if (!buffer.empty()) {
+            ++_pipelined_requests;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Minimal stand-in for a ReportPortal server listening on 127.0.0.1. It
+// understands just enough HTTP/1.1 to answer every request with a canned
+// response the client can deserialize, keeps connections alive and counts
+// what it sees. POSIX only.
+class loopback_server
+{
+    public:
+        // Connections that stay quiet for idle_timeout are closed, the way
+        // servers behind a load balancer drop idle keep-alive connections.
+        // Zero keeps them open for as long as the client wants. Every response
+        // is held back for response_delay, standing in for the round trip to
+        // a remote server.
+        explicit loopback_server(
+            std::chrono::milliseconds idle_timeout = std::chrono::milliseconds(0),
+            std::chrono::microseconds response_delay = std::chrono::microseconds(0));
+
+        // Stops accepting and closes every open connection.
+        ~loopback_server();
+
+        loopback_server(const loopback_server&) = delete;
+        loopback_server& operator=(const loopback_server&) = delete;
+
+        // Base url to hand to report_portal::service, e.g. http://127.0.0.1:4242
+        std::string url() const;
+
+        uint64_t accepted_connections() const;
+        uint64_t requests() const;
+        uint64_t bytes_received() const;
+
+        // Requests that had already arrived while the one before them on the
+        // same connection was being answered, i.e. were pipelined.
+        uint64_t pipelined_requests() const;
+
+        // Connections closed by the server for being idle too long.
+        uint64_t idle_closes() const;
+
+    private:
+        void accept_connections();
+        void serve(int connection);
+        void exchange(int connection);
+
+        int _listener = -1;
+        uint16_t _port = 0;
+        const std::chrono::milliseconds _idle_timeout;
+        const std::chrono::microseconds _response_delay;
+
+        std::atomic<bool> _stopping{false};
+        std::atomic<uint64_t> _accepted_connections{0};
+        std::atomic<uint64_t> _requests{0};
+        std::atomic<uint64_t> _bytes_received{0};
+        std::atomic<uint64_t> _pipelined_requests{0};
+        std::atomic<uint64_t> _idle_closes{0};
+
+        std::mutex _mutex;
+        std::vector<int> _connections;
+        std::vector<std::thread> _workers;
+        std::thread _acceptor;
+};
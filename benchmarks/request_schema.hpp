@@ -0,0 +1,167 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <uuid.h>
+#include <reportportal/test_item.hpp>
+
+#include <json_writer.hpp>
+#include <request_serializer.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Members of the requests the agent sends. Each names its JSON key and whether
+// its value is written as a string.
+namespace fields
+{
+
+struct name { static constexpr std::string_view key = "name"; static constexpr bool quoted = true; };
+struct description { static constexpr std::string_view key = "description"; static constexpr bool quoted = true; };
+struct start_time { static constexpr std::string_view key = "startTime"; static constexpr bool quoted = true; };
+struct end_time { static constexpr std::string_view key = "endTime"; static constexpr bool quoted = true; };
+struct time { static constexpr std::string_view key = "time"; static constexpr bool quoted = true; };
+struct type { static constexpr std::string_view key = "type"; static constexpr bool quoted = true; };
+struct status { static constexpr std::string_view key = "status"; static constexpr bool quoted = true; };
+struct launch_uuid { static constexpr std::string_view key = "launchUuid"; static constexpr bool quoted = true; };
+struct item_uuid { static constexpr std::string_view key = "itemUuid"; static constexpr bool quoted = true; };
+struct message { static constexpr std::string_view key = "message"; static constexpr bool quoted = true; };
+struct level { static constexpr std::string_view key = "level"; static constexpr bool quoted = true; };
+
+}
+
+// Writes the contents of a member's value, without the quotes of a string.
+inline void append_value(std::string& out, std::string_view text)
+{
+    append_escaped(out, text);
+}
+
+inline void append_value(std::string& out, std::chrono::system_clock::time_point time)
+{
+    append_timestamp(out, time);
+}
+
+inline void append_value(std::string& out, const uuids::uuid& id)
+{
+    append_uuid(out, id);
+}
+
+inline void append_value(std::string& out, report_portal::test_item_type type)
+{
+    out.append(to_json_name(type));
+}
+
+inline void append_value(std::string& out, report_portal::test_item_status status)
+{
+    out.append(to_json_name(status));
+}
+
+inline void append_value(std::string& out, report_portal::log_level level)
+{
+    out.append(to_json_name(level));
+}
+
+// A JSON object whose members are always the given fields in the given order.
+// Everything but the values is known at compile time, so the text between two
+// values, e.g. `","startTime":"` between a name and a start time, is built
+// once by the compiler and writing an object only copies those fragments and
+// splices the values in between.
+template <typename... Fields>
+class request_schema
+{
+    public:
+        static constexpr std::size_t field_count = sizeof...(Fields);
+
+        // Appends the object with the given values, one per field, to out.
+        template <typename... Values>
+        static void append(std::string& out, const Values&... values) {
+            static_assert(sizeof...(Values) == field_count, "request_schema needs one value per field");
+
+            std::size_t fragment = 0;
+            ((append_fragment(out, fragment++), append_value(out, values)), ...);
+            append_fragment(out, fragment);
+        }
+
+    private:
+        static constexpr std::array<std::string_view, field_count> keys = {Fields::key...};
+        static constexpr std::array<bool, field_count> quoted = {Fields::quoted...};
+
+        // Fragment i holds what comes before value i: the quote closing the
+        // previous value, the separator, the key and the quote opening value
+        // i. The last fragment closes the object.
+        static constexpr std::size_t fragment_size(std::size_t i) {
+            std::size_t size = 1;
+            if (i > 0 && quoted[i - 1]) {
+                ++size;
+            }
+            if (i < field_count) {
+                size += keys[i].size() + 3 + (quoted[i] ? 1 : 0);
+            }
+            return size;
+        }
+
+        static constexpr std::size_t text_size() {
+            std::size_t size = 0;
+            for (std::size_t i = 0; i <= field_count; ++i) {
+                size += fragment_size(i);
+            }
+            return size;
+        }
+
+        static constexpr std::array<char, text_size()> make_text() {
+            std::array<char, text_size()> text = {};
+            std::size_t at = 0;
+            for (std::size_t i = 0; i <= field_count; ++i) {
+                if (i > 0 && quoted[i - 1]) {
+                    text[at++] = '"';
+                }
+                if (i == field_count) {
+                    text[at++] = '}';
+                    break;
+                }
+
+                text[at++] = i == 0 ? '{' : ',';
+                text[at++] = '"';
+                for (char c : keys[i]) {
+                    text[at++] = c;
+                }
+                text[at++] = '"';
+                text[at++] = ':';
+                if (quoted[i]) {
+                    text[at++] = '"';
+                }
+            }
+            return text;
+        }
+
+        static constexpr std::array<std::size_t, field_count + 2> make_offsets() {
+            std::array<std::size_t, field_count + 2> offsets = {};
+            for (std::size_t i = 0; i <= field_count; ++i) {
+                offsets[i + 1] = offsets[i] + fragment_size(i);
+            }
+            return offsets;
+        }
+
+        static constexpr std::array<char, text_size()> text = make_text();
+        static constexpr std::array<std::size_t, field_count + 2> offsets = make_offsets();
+
+        static void append_fragment(std::string& out, std::size_t i) {
+            out.append(text.data() + offsets[i], offsets[i + 1] - offsets[i]);
+        }
+};
+
+using begin_test_item_schema = request_schema<fields::name, fields::start_time, fields::type, fields::launch_uuid>;
+using begin_test_item_with_description_schema =
+    request_schema<fields::name, fields::start_time, fields::type, fields::launch_uuid, fields::description>;
+using end_test_item_schema = request_schema<fields::end_time, fields::launch_uuid>;
+using end_test_item_with_status_schema = request_schema<fields::end_time, fields::launch_uuid, fields::status>;
+using log_schema = request_schema<fields::launch_uuid, fields::time, fields::item_uuid, fields::message, fields::level>;
+
+}
+}
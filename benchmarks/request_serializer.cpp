@@ -0,0 +1,180 @@
+#include <request_serializer.hpp>
+
+#include <json_writer.hpp>
+#include <request_schema.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+void request_serializer::serialize_begin_launch(
+    std::string& body,
+    std::string_view name,
+    std::chrono::system_clock::time_point start_time,
+    std::string_view description,
+    const uuids::uuid& rerun_of) const {
+    body.clear();
+    json_writer writer(body);
+    writer.begin_object();
+    writer.key("name");
+    writer.value(name);
+    writer.key("startTime");
+    writer.value(start_time);
+    if (!description.empty()) {
+        writer.key("description");
+        writer.value(description);
+    }
+    if (!rerun_of.is_nil()) {
+        writer.key("rerun");
+        writer.value(true);
+        writer.key("rerunOf");
+        writer.value(rerun_of);
+    }
+    writer.end_object();
+}
+
+void request_serializer::serialize_end_launch(std::string& body, std::chrono::system_clock::time_point end_time) const {
+    body.clear();
+    json_writer writer(body);
+    writer.begin_object();
+    writer.key("endTime");
+    writer.value(end_time);
+    writer.end_object();
+}
+
+// Test item and log requests are made for every test, so they are written from
+// schemas rather than member by member.
+void request_serializer::serialize_begin_test_item(
+    std::string& body,
+    std::string_view name,
+    std::chrono::system_clock::time_point start_time,
+    report_portal::test_item_type type,
+    const uuids::uuid& launch_id,
+    std::string_view description) const {
+    body.clear();
+    if (description.empty()) {
+        begin_test_item_schema::append(body, name, start_time, type, launch_id);
+    } else {
+        begin_test_item_with_description_schema::append(body, name, start_time, type, launch_id, description);
+    }
+}
+
+void request_serializer::serialize_end_test_item(
+    std::string& body,
+    std::chrono::system_clock::time_point end_time,
+    const uuids::uuid& launch_id,
+    report_portal::test_item_status status) const {
+    body.clear();
+    if (status == report_portal::test_item_status::inherit) {
+        end_test_item_schema::append(body, end_time, launch_id);
+    } else {
+        end_test_item_with_status_schema::append(body, end_time, launch_id, status);
+    }
+}
+
+void request_serializer::begin_batched_logs(std::string& body) const {
+    body.clear();
+    body.push_back('[');
+}
+
+void request_serializer::append_log(
+    std::string& body,
+    const uuids::uuid& launch_id,
+    const uuids::uuid& test_item_id,
+    std::chrono::system_clock::time_point time,
+    report_portal::log_level level,
+    std::string_view message) const {
+    if (body.back() != '[') {
+        body.push_back(',');
+    }
+
+    log_schema::append(body, launch_id, time, test_item_id, message, level);
+}
+
+void request_serializer::end_batched_logs(std::string& body) const {
+    body.push_back(']');
+}
+
+const char* to_json_name(report_portal::test_item_type type)
+{
+    switch (type) {
+        case report_portal::test_item_type::suite:
+            return "suite";
+        case report_portal::test_item_type::story:
+            return "story";
+        case report_portal::test_item_type::test:
+            return "test";
+        case report_portal::test_item_type::scenario:
+            return "scenario";
+        case report_portal::test_item_type::step:
+            return "step";
+        case report_portal::test_item_type::before_class:
+            return "before_class";
+        case report_portal::test_item_type::before_groups:
+            return "before_groups";
+        case report_portal::test_item_type::before_method:
+            return "before_method";
+        case report_portal::test_item_type::before_suite:
+            return "before_suite";
+        case report_portal::test_item_type::before_test:
+            return "before_test";
+        case report_portal::test_item_type::after_class:
+            return "after_class";
+        case report_portal::test_item_type::after_groups:
+            return "after_groups";
+        case report_portal::test_item_type::after_method:
+            return "after_method";
+        case report_portal::test_item_type::after_suite:
+            return "after_suite";
+        case report_portal::test_item_type::after_test:
+            return "after_test";
+    }
+
+    return "suite";
+}
+
+const char* to_json_name(report_portal::test_item_status status)
+{
+    switch (status) {
+        case report_portal::test_item_status::inherit:
+            return "inherit";
+        case report_portal::test_item_status::passed:
+            return "passed";
+        case report_portal::test_item_status::failed:
+            return "failed";
+        case report_portal::test_item_status::stopped:
+            return "stopped";
+        case report_portal::test_item_status::skipped:
+            return "skipped";
+        case report_portal::test_item_status::interrupted:
+            return "interrupted";
+        case report_portal::test_item_status::cancelled:
+            return "cancelled";
+    }
+
+    return "inherit";
+}
+
+const char* to_json_name(report_portal::log_level level)
+{
+    switch (level) {
+        case report_portal::log_level::trace:
+            return "trace";
+        case report_portal::log_level::debug:
+            return "debug";
+        case report_portal::log_level::info:
+            return "info";
+        case report_portal::log_level::warn:
+            return "warn";
+        case report_portal::log_level::error:
+            return "error";
+        case report_portal::log_level::fatal:
+            return "fatal";
+    }
+
+    return "error";
+}
+
+}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include <uuid.h>
+#include <reportportal/test_item.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Writes the bodies of the requests the agent makes to ReportPortal into a
+// buffer owned by the caller, producing the same JSON as
+// report_portal::rapidjson_serializer does for these requests. Each call
+// replaces the contents of body but keeps its memory, so serializing a request
+// into a buffer that is reused does not allocate.
+//
+// Optional members are left out when empty: the description, the launch to
+// rerun when nil and the status when it is inherit.
+//
+// Only the benchmarks use it: report_portal::service serializes with its own
+// rapidjson_serializer and cannot be given another, so this is not part of
+// the agent.
+class request_serializer
+{
+    public:
+        void serialize_begin_launch(
+            std::string& body,
+            std::string_view name,
+            std::chrono::system_clock::time_point start_time,
+            std::string_view description,
+            const uuids::uuid& rerun_of) const;
+
+        void serialize_end_launch(std::string& body, std::chrono::system_clock::time_point end_time) const;
+
+        void serialize_begin_test_item(
+            std::string& body,
+            std::string_view name,
+            std::chrono::system_clock::time_point start_time,
+            report_portal::test_item_type type,
+            const uuids::uuid& launch_id,
+            std::string_view description) const;
+
+        void serialize_end_test_item(
+            std::string& body,
+            std::chrono::system_clock::time_point end_time,
+            const uuids::uuid& launch_id,
+            report_portal::test_item_status status) const;
+
+        // A batch of logs is an array of entries: begin it, append each entry
+        // and end it.
+        void begin_batched_logs(std::string& body) const;
+        void append_log(
+            std::string& body,
+            const uuids::uuid& launch_id,
+            const uuids::uuid& test_item_id,
+            std::chrono::system_clock::time_point time,
+            report_portal::log_level level,
+            std::string_view message) const;
+        void end_batched_logs(std::string& body) const;
+};
+
+// Names ReportPortal uses for the enumerations in requests.
+const char* to_json_name(report_portal::test_item_type type);
+const char* to_json_name(report_portal::test_item_status status);
+const char* to_json_name(report_portal::log_level level);
+
+}
+}
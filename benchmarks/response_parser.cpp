@@ -0,0 +1,284 @@
+#include <response_parser.hpp>
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+namespace
+{
+
+int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+void append_utf8(char*& out, uint32_t code_point)
+{
+    if (code_point < 0x80) {
+        *out++ = static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        *out++ = static_cast<char>(0xc0 | (code_point >> 6));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    } else if (code_point < 0x10000) {
+        *out++ = static_cast<char>(0xe0 | (code_point >> 12));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    } else {
+        *out++ = static_cast<char>(0xf0 | (code_point >> 18));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+        *out++ = static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        *out++ = static_cast<char>(0x80 | (code_point & 0x3f));
+    }
+}
+
+class response_scanner
+{
+    public:
+        response_scanner(char* begin, char* end)
+          : _position(begin),
+            _end(end)
+        {}
+
+        response_fields parse() {
+            response_fields fields;
+
+            expect('{');
+            if (!consume('}')) {
+                do {
+                    const std::string_view key = string();
+                    expect(':');
+                    if (key == "id") {
+                        fields.id = uuid(string());
+                    } else if (key == "number") {
+                        fields.number = number();
+                    } else if (key == "link") {
+                        fields.link = string();
+                    } else if (key == "message") {
+                        fields.message = string();
+                    } else {
+                        skip_value();
+                    }
+                } while (consume(','));
+                expect('}');
+            }
+
+            skip_whitespace();
+            if (_position != _end) {
+                fail("Unexpected text after the response");
+            }
+            return fields;
+        }
+
+    private:
+        [[noreturn]] static void fail(const char* what) {
+            throw std::runtime_error(what);
+        }
+
+        void skip_whitespace() {
+            while (_position != _end && (*_position == ' ' || *_position == '\n' || *_position == '\r' || *_position == '\t')) {
+                ++_position;
+            }
+        }
+
+        bool consume(char c) {
+            skip_whitespace();
+            if (_position != _end && *_position == c) {
+                ++_position;
+                return true;
+            }
+            return false;
+        }
+
+        void expect(char c) {
+            if (!consume(c)) {
+                fail("Malformed response");
+            }
+        }
+
+        char peek() {
+            skip_whitespace();
+            if (_position == _end) {
+                fail("Response ends unexpectedly");
+            }
+            return *_position;
+        }
+
+        uint32_t hex4() {
+            if (_end - _position < 4) {
+                fail("Response ends inside an escape");
+            }
+
+            uint32_t value = 0;
+            for (int i = 0; i < 4; ++i) {
+                const int digit = hex_value(*_position++);
+                if (digit < 0) {
+                    fail("Malformed escape in response");
+                }
+                value = (value << 4) | static_cast<uint32_t>(digit);
+            }
+            return value;
+        }
+
+        // Unescapes the string in place. The unescaped text is never longer
+        // than the escaped one, so it is written over the body as it is read.
+        std::string_view string() {
+            expect('"');
+
+            // Most strings have no escapes and are used where they are.
+            char* const begin = _position;
+            char* const quote = static_cast<char*>(std::memchr(begin, '"', _end - begin));
+            if (quote && !std::memchr(begin, '\\', quote - begin)) {
+                _position = quote + 1;
+                return std::string_view(begin, quote - begin);
+            }
+
+            char* out = _position;
+            while (true) {
+                if (_position == _end) {
+                    fail("Response ends inside a string");
+                }
+
+                const char c = *_position++;
+                if (c == '"') {
+                    return std::string_view(begin, out - begin);
+                }
+                if (c != '\\') {
+                    *out++ = c;
+                    continue;
+                }
+
+                if (_position == _end) {
+                    fail("Response ends inside an escape");
+                }
+                switch (*_position++) {
+                    case '"': *out++ = '"'; break;
+                    case '\\': *out++ = '\\'; break;
+                    case '/': *out++ = '/'; break;
+                    case 'b': *out++ = '\b'; break;
+                    case 'f': *out++ = '\f'; break;
+                    case 'n': *out++ = '\n'; break;
+                    case 'r': *out++ = '\r'; break;
+                    case 't': *out++ = '\t'; break;
+                    case 'u': {
+                        uint32_t code_point = hex4();
+                        if (code_point >= 0xd800 && code_point < 0xdc00
+                            && _end - _position >= 6 && _position[0] == '\\' && _position[1] == 'u') {
+                            _position += 2;
+                            const uint32_t low = hex4();
+                            if (low < 0xdc00 || low >= 0xe000) {
+                                fail("Malformed surrogate pair in response");
+                            }
+                            code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+                        }
+                        append_utf8(out, code_point);
+                        break;
+                    }
+                    default:
+                        fail("Malformed escape in response");
+                }
+            }
+        }
+
+        uint64_t number() {
+            if (peek() < '0' || *_position > '9') {
+                fail("Expected a number in response");
+            }
+
+            uint64_t value = 0;
+            while (_position != _end && *_position >= '0' && *_position <= '9') {
+                const uint64_t digit = static_cast<uint64_t>(*_position++ - '0');
+                if (value > (UINT64_MAX - digit) / 10) {
+                    fail("Number in response is too large");
+                }
+                value = value * 10 + digit;
+            }
+            return value;
+        }
+
+        static uuids::uuid uuid(std::string_view text) {
+            // 8-4-4-4-12 hex digits.
+            if (text.size() != 36) {
+                fail("Malformed uuid in response");
+            }
+
+            std::array<uint8_t, 16> bytes = {};
+            std::size_t byte = 0;
+            for (std::size_t i = 0; i < text.size(); ) {
+                if (i == 8 || i == 13 || i == 18 || i == 23) {
+                    if (text[i] != '-') {
+                        fail("Malformed uuid in response");
+                    }
+                    ++i;
+                    continue;
+                }
+
+                const int high = hex_value(text[i]);
+                const int low = hex_value(text[i + 1]);
+                if (high < 0 || low < 0) {
+                    fail("Malformed uuid in response");
+                }
+                bytes[byte++] = static_cast<uint8_t>((high << 4) | low);
+                i += 2;
+            }
+            return uuids::uuid(bytes.begin(), bytes.end());
+        }
+
+        void skip_value() {
+            const char c = peek();
+            if (c == '"') {
+                string();
+            } else if (c == '{' || c == '[') {
+                // Strings are skipped whole so brackets inside them do not
+                // count.
+                int depth = 0;
+                do {
+                    const char next = peek();
+                    if (next == '"') {
+                        string();
+                        continue;
+                    }
+
+                    ++_position;
+                    if (next == '{' || next == '[') {
+                        ++depth;
+                    } else if (next == '}' || next == ']') {
+                        --depth;
+                    }
+                } while (depth > 0);
+            } else {
+                // Numbers, true, false and null.
+                while (_position != _end && *_position != ',' && *_position != '}' && *_position != ']'
+                       && *_position != ' ' && *_position != '\n' && *_position != '\r' && *_position != '\t') {
+                    ++_position;
+                }
+            }
+        }
+
+        char* _position;
+        char* const _end;
+};
+
+}
+
+response_fields parse_response(std::string& body)
+{
+    char* const begin = &body[0];
+    return response_scanner(begin, begin + body.size()).parse();
+}
+
+}
+}
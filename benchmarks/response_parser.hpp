@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <uuid.h>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// The members of a ReportPortal response the agent cares about. Strings point
+// into the parsed body.
+struct response_fields
+{
+    std::optional<uuids::uuid> id;
+    std::optional<uint64_t> number;
+    std::optional<std::string_view> link;
+    std::optional<std::string_view> message;
+};
+
+// Extracts id, number, link and message from the top level of a response
+// without building a document: the body is scanned once, other members are
+// skipped, and strings are unescaped in place, which is why the body has to be
+// writable. Nothing is allocated.
+//
+// Throws std::runtime_error when the body is not a JSON object or one of the
+// members has the wrong type.
+//
+// The client parses its own responses with rapidjson and takes no other
+// parser, so this only serves the benchmarks that measure it against that.
+response_fields parse_response(std::string& body);
+
+}
+}
@@ -0,0 +1,266 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <reportportal/rapidjson_serializer.hpp>
+
+#include <allocation_counter.hpp>
+#include <json_writer.hpp>
+#include <request_serializer.hpp>
+#include <response_parser.hpp>
+
+// Compares report_portal::rapidjson_serializer, which builds a document and
+// returns a new string for every request, with request_serializer streaming
+// into a buffer that is reused from one request to the next. The Generic
+// benchmarks write the same requests member by member with json_writer, to
+// show what the fixed request schemas request_serializer uses save.
+//
+// The Parse benchmarks compare the rapidjson_serializer deserializers with
+// parse_response on the responses ReportPortal sends back.
+
+namespace {
+
+const uuids::uuid launch_id = uuids::uuid::from_string("47183823-2574-4bfd-b411-99ed177d3e43");
+const uuids::uuid test_item_id = uuids::uuid::from_string("57183823-2574-4bfd-b411-99ed177d3e43");
+const std::string test_name = "SyntheticSuite.SyntheticTestWithAReasonablyLongName";
+const std::string end_launch_response =
+    "{\"id\":\"47183823-2574-4bfd-b411-99ed177d3e43\",\"number\":1234,"
+    "\"link\":\"http://localhost:8080/ui/#default_personal/launches/all/47183823-2574-4bfd-b411-99ed177d3e43\"}";
+const std::string end_test_item_response =
+    "{\"message\":\"TestItem with ID = '57183823-2574-4bfd-b411-99ed177d3e43' successfully finished.\"}";
+const std::string failure =
+    "file = synthetic_tests.cpp\nline = 42\nValue of: \"expected\"\n  Actual: \"actual\"\nExpected: true";
+
+// Reports allocations per request alongside the time.
+class allocations_per_request
+{
+    public:
+        explicit allocations_per_request(benchmark::State& state)
+          : _state(state),
+            _before(allocation_count())
+        {}
+
+        ~allocations_per_request() {
+            const double requests = static_cast<double>(_state.iterations());
+            _state.counters["allocs/request"] = requests ? (allocation_count() - _before) / requests : 0.0;
+        }
+
+    private:
+        benchmark::State& _state;
+        const uint64_t _before;
+};
+
+}
+
+static void RapidjsonBeginTestItem(benchmark::State& state)
+{
+    report_portal::rapidjson_serializer serializer;
+    const auto start_time = std::chrono::system_clock::now();
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        std::string body = serializer.serialize_begin_test_item(
+            test_name,
+            start_time,
+            report_portal::test_item_type::step,
+            launch_id,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt);
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(RapidjsonBeginTestItem);
+
+static void StreamingBeginTestItem(benchmark::State& state)
+{
+    reportportal::gtest::request_serializer serializer;
+    const auto start_time = std::chrono::system_clock::now();
+    std::string body;
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        serializer.serialize_begin_test_item(body, test_name, start_time, report_portal::test_item_type::step, launch_id, "");
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(StreamingBeginTestItem);
+
+static void GenericBeginTestItem(benchmark::State& state)
+{
+    const auto start_time = std::chrono::system_clock::now();
+    std::string body;
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        body.clear();
+        reportportal::gtest::json_writer writer(body);
+        writer.begin_object();
+        writer.key("name");
+        writer.value(test_name);
+        writer.key("startTime");
+        writer.value(start_time);
+        writer.key("type");
+        writer.value("step");
+        writer.key("launchUuid");
+        writer.value(launch_id);
+        writer.end_object();
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(GenericBeginTestItem);
+
+static void RapidjsonEndTestItem(benchmark::State& state)
+{
+    report_portal::rapidjson_serializer serializer;
+    const auto end_time = std::chrono::system_clock::now();
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        std::string body = serializer.serialize_end_test_item(
+            end_time,
+            launch_id,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt);
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(RapidjsonEndTestItem);
+
+static void StreamingEndTestItem(benchmark::State& state)
+{
+    reportportal::gtest::request_serializer serializer;
+    const auto end_time = std::chrono::system_clock::now();
+    std::string body;
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        serializer.serialize_end_test_item(body, end_time, launch_id, report_portal::test_item_status::inherit);
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(StreamingEndTestItem);
+
+// range(0) log entries per batch.
+static void RapidjsonBatchedLogs(benchmark::State& state)
+{
+    report_portal::rapidjson_serializer serializer;
+    const auto time = std::chrono::system_clock::now();
+    const std::vector<report_portal::log> logs(
+        state.range(0),
+        report_portal::log(launch_id, test_item_id, time, report_portal::log_level::error, failure));
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        std::string body = serializer.serialize_batched_logs(logs);
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(RapidjsonBatchedLogs)->Arg(1)->Arg(16);
+
+static void StreamingBatchedLogs(benchmark::State& state)
+{
+    reportportal::gtest::request_serializer serializer;
+    const auto time = std::chrono::system_clock::now();
+    std::string body;
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        serializer.begin_batched_logs(body);
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            serializer.append_log(body, launch_id, test_item_id, time, report_portal::log_level::error, failure);
+        }
+        serializer.end_batched_logs(body);
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(StreamingBatchedLogs)->Arg(1)->Arg(16);
+
+static void GenericBatchedLogs(benchmark::State& state)
+{
+    const auto time = std::chrono::system_clock::now();
+    std::string body;
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        body.clear();
+        reportportal::gtest::json_writer writer(body);
+        writer.begin_array();
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            writer.begin_object();
+            writer.key("launchUuid");
+            writer.value(launch_id);
+            writer.key("time");
+            writer.value(time);
+            writer.key("itemUuid");
+            writer.value(test_item_id);
+            writer.key("message");
+            writer.value(failure);
+            writer.key("level");
+            writer.value("error");
+            writer.end_object();
+        }
+        writer.end_array();
+        benchmark::DoNotOptimize(body);
+    }
+}
+BENCHMARK(GenericBatchedLogs)->Arg(1)->Arg(16);
+
+static void RapidjsonParseEndLaunch(benchmark::State& state)
+{
+    report_portal::rapidjson_serializer serializer;
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        report_portal::end_launch_responce response = serializer.deserialize_end_launch_responce(end_launch_response);
+        benchmark::DoNotOptimize(response);
+    }
+}
+BENCHMARK(RapidjsonParseEndLaunch);
+
+static void InSituParseEndLaunch(benchmark::State& state)
+{
+    // The body is copied into a reused buffer every time since parsing
+    // unescapes it in place, as a response buffer would be.
+    std::string body;
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        body.assign(end_launch_response);
+        reportportal::gtest::response_fields fields = reportportal::gtest::parse_response(body);
+        benchmark::DoNotOptimize(fields);
+    }
+}
+BENCHMARK(InSituParseEndLaunch);
+
+static void RapidjsonParseEndTestItem(benchmark::State& state)
+{
+    report_portal::rapidjson_serializer serializer;
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        report_portal::end_test_item_responce response = serializer.deserialize_end_test_item_responce(end_test_item_response);
+        benchmark::DoNotOptimize(response);
+    }
+}
+BENCHMARK(RapidjsonParseEndTestItem);
+
+static void InSituParseEndTestItem(benchmark::State& state)
+{
+    std::string body;
+
+    allocations_per_request allocations(state);
+    for (auto _ : state) {
+        body.assign(end_test_item_response);
+        reportportal::gtest::response_fields fields = reportportal::gtest::parse_response(body);
+        benchmark::DoNotOptimize(fields);
+    }
+}
+BENCHMARK(InSituParseEndTestItem);
@@ -0,0 +1,200 @@
+#include <synthetic_tests.hpp>
+
+#include <allocation_counter.hpp>
+
+#include <map>
+#include <tuple>
+
+namespace {
+
+class synthetic_test : public ::testing::Test
+{
+    public:
+        explicit synthetic_test(int failures)
+          : _failures(failures)
+        {}
+
+        void TestBody() override {
+            for (int i = 0; i < _failures; ++i) {
+                ADD_FAILURE() << "synthetic failure " << i;
+            }
+        }
+
+    private:
+        const int _failures;
+};
+
+void initialize_gtest()
+{
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+
+    ::testing::InitGoogleTest();
+
+    // Keep gtest's console output from drowning the benchmark results.
+    ::testing::TestEventListeners& listeners = ::testing::UnitTest::GetInstance()->listeners();
+    delete listeners.Release(listeners.default_result_printer());
+    initialized = true;
+}
+
+}
+
+std::string register_synthetic_tests(int suites, int tests, int failures)
+{
+    initialize_gtest();
+
+    static std::map<std::tuple<int, int, int>, std::string> registered;
+    const auto shape = std::make_tuple(suites, tests, failures);
+    const auto found = registered.find(shape);
+    if (found != registered.end()) {
+        return found->second;
+    }
+
+    const std::string prefix =
+        "Synthetic_" + std::to_string(suites) +
+        "_" + std::to_string(tests) +
+        "_" + std::to_string(failures) + "_";
+    for (int suite = 0; suite < suites; ++suite) {
+        const std::string suite_name = prefix + std::to_string(suite);
+        for (int test = 0; test < tests; ++test) {
+            const std::string test_name = "Test" + std::to_string(test);
+            ::testing::RegisterTest(
+                suite_name.c_str(), test_name.c_str(), nullptr, nullptr, __FILE__, __LINE__,
+                [failures]() -> synthetic_test* { return new synthetic_test(failures); });
+        }
+    }
+
+    return registered[shape] = prefix + "*";
+}
+
+void run_synthetic_tests(const std::string& filter, ::testing::TestEventListener* listener)
+{
+    ::testing::GTEST_FLAG(filter) = filter;
+
+    ::testing::TestEventListeners& listeners = ::testing::UnitTest::GetInstance()->listeners();
+    if (listener) {
+        listeners.Append(listener);
+    }
+
+    // Synthetic tests fail on purpose so the result is not interesting.
+    const int result = RUN_ALL_TESTS();
+    static_cast<void>(result);
+
+    if (listener) {
+        listeners.Release(listener);
+    }
+}
+
+void counting_reporter::report(const reportportal::gtest::event& e)
+{
+    ++events;
+    log_entries += e.logs.size();
+}
+
+void counting_reporter::flush()
+{
+}
+
+class measuring_listener::measurement
+{
+    public:
+        explicit measurement(measuring_listener& listener)
+          : _listener(listener),
+            _allocations(allocation_count()),
+            _start(std::chrono::steady_clock::now())
+        {}
+
+        ~measurement() {
+            _listener.elapsed += std::chrono::steady_clock::now() - _start;
+            _listener.allocations += allocation_count() - _allocations;
+        }
+
+    private:
+        measuring_listener& _listener;
+        const uint64_t _allocations;
+        const std::chrono::steady_clock::time_point _start;
+};
+
+measuring_listener::measuring_listener(::testing::TestEventListener& listener)
+  : _listener(listener)
+{}
+
+void measuring_listener::OnTestProgramStart(const ::testing::UnitTest& unit_test)
+{
+    const measurement measure(*this);
+    _listener.OnTestProgramStart(unit_test);
+}
+
+void measuring_listener::OnTestIterationStart(const ::testing::UnitTest& unit_test, int iteration)
+{
+    const measurement measure(*this);
+    _listener.OnTestIterationStart(unit_test, iteration);
+}
+
+void measuring_listener::OnEnvironmentsSetUpStart(const ::testing::UnitTest& unit_test)
+{
+    const measurement measure(*this);
+    _listener.OnEnvironmentsSetUpStart(unit_test);
+}
+
+void measuring_listener::OnEnvironmentsSetUpEnd(const ::testing::UnitTest& unit_test)
+{
+    const measurement measure(*this);
+    _listener.OnEnvironmentsSetUpEnd(unit_test);
+}
+
+void measuring_listener::OnTestSuiteStart(const ::testing::TestSuite& test_suite)
+{
+    const measurement measure(*this);
+    _listener.OnTestSuiteStart(test_suite);
+}
+
+void measuring_listener::OnTestStart(const ::testing::TestInfo& test_info)
+{
+    const measurement measure(*this);
+    _listener.OnTestStart(test_info);
+}
+
+void measuring_listener::OnTestPartResult(const ::testing::TestPartResult& test_part_result)
+{
+    const measurement measure(*this);
+    _listener.OnTestPartResult(test_part_result);
+}
+
+void measuring_listener::OnTestEnd(const ::testing::TestInfo& test_info)
+{
+    const measurement measure(*this);
+    _listener.OnTestEnd(test_info);
+}
+
+void measuring_listener::OnTestSuiteEnd(const ::testing::TestSuite& test_suite)
+{
+    const measurement measure(*this);
+    _listener.OnTestSuiteEnd(test_suite);
+}
+
+void measuring_listener::OnEnvironmentsTearDownStart(const ::testing::UnitTest& unit_test)
+{
+    const measurement measure(*this);
+    _listener.OnEnvironmentsTearDownStart(unit_test);
+}
+
+void measuring_listener::OnEnvironmentsTearDownEnd(const ::testing::UnitTest& unit_test)
+{
+    const measurement measure(*this);
+    _listener.OnEnvironmentsTearDownEnd(unit_test);
+}
+
+void measuring_listener::OnTestIterationEnd(const ::testing::UnitTest& unit_test, int iteration)
+{
+    const measurement measure(*this);
+    _listener.OnTestIterationEnd(unit_test, iteration);
+}
+
+void measuring_listener::OnTestProgramEnd(const ::testing::UnitTest& unit_test)
+{
+    const measurement measure(*this);
+    _listener.OnTestProgramEnd(unit_test);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <reportportal/gtest/ireporter.hpp>
+
+// Registers a synthetic test program of suites x tests where every test fails
+// failures times. Returns the gtest filter that selects just these tests.
+// Registering the same shape again returns the existing filter.
+std::string register_synthetic_tests(int suites, int tests, int failures);
+
+// Runs the tests selected by filter with listener appended to gtest's
+// listeners. The listener stays owned by the caller.
+void run_synthetic_tests(const std::string& filter, ::testing::TestEventListener* listener);
+
+// Drops every event, only counting what it sees.
+class counting_reporter : public reportportal::gtest::ireporter
+{
+    public:
+        void report(const reportportal::gtest::event& e) override;
+        void flush() override;
+
+        uint64_t events = 0;
+        uint64_t log_entries = 0;
+};
+
+// Forwards every callback to another listener, adding up the time spent and
+// the allocations made inside that listener only.
+class measuring_listener : public ::testing::TestEventListener
+{
+    public:
+        explicit measuring_listener(::testing::TestEventListener& listener);
+
+        void OnTestProgramStart(const ::testing::UnitTest& unit_test) override;
+        void OnTestIterationStart(const ::testing::UnitTest& unit_test, int iteration) override;
+        void OnEnvironmentsSetUpStart(const ::testing::UnitTest& unit_test) override;
+        void OnEnvironmentsSetUpEnd(const ::testing::UnitTest& unit_test) override;
+        void OnTestSuiteStart(const ::testing::TestSuite& test_suite) override;
+        void OnTestStart(const ::testing::TestInfo& test_info) override;
+        void OnTestPartResult(const ::testing::TestPartResult& test_part_result) override;
+        void OnTestEnd(const ::testing::TestInfo& test_info) override;
+        void OnTestSuiteEnd(const ::testing::TestSuite& test_suite) override;
+        void OnEnvironmentsTearDownStart(const ::testing::UnitTest& unit_test) override;
+        void OnEnvironmentsTearDownEnd(const ::testing::UnitTest& unit_test) override;
+        void OnTestIterationEnd(const ::testing::UnitTest& unit_test, int iteration) override;
+        void OnTestProgramEnd(const ::testing::UnitTest& unit_test) override;
+
+        std::chrono::nanoseconds elapsed{0};
+        uint64_t allocations = 0;
+
+    private:
+        class measurement;
+
+        ::testing::TestEventListener& _listener;
+};
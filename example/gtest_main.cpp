@@ -1,3 +1,5 @@
+#include <memory>
+
 #include <gtest/gtest.h>
 #include <reportportal/gtest/event_listener.hpp>
 
@@ -5,7 +7,13 @@ int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
     ::testing::TestEventListeners& listeners = ::testing::UnitTest::GetInstance()->listeners();
-    report_portal::service service("http://web.demo.reportportal.io", "DEFAULT_PERSONAL", "default", "1q2w3e");
-    listeners.Append(new reportportal::gtest::event_listener(service));
+    // The listener outlives main, so it is given the service to own.
+    auto service = std::make_unique<report_portal::service>(
+        "http://web.demo.reportportal.io", "DEFAULT_PERSONAL", "default", "1q2w3e");
+
+    reportportal::gtest::listener_options options;
+    options.asynchronous = true;
+    reportportal::gtest::apply_environment(options);
+    listeners.Append(new reportportal::gtest::event_listener(std::move(service), options));
     return RUN_ALL_TESTS();
 }
@@ -0,0 +1,356 @@
+#include <reportportal/gtest/async_reporter.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Bytes an event takes up in the queue.
+static std::size_t footprint(const event& e)
+{
+    std::size_t bytes = sizeof(event) + e.name.size() + e.description.size();
+    for (const log_entry& entry : e.logs) {
+        bytes += sizeof(log_entry) + entry.message.size();
+    }
+    return bytes;
+}
+
+async_reporter::async_reporter(
+    std::unique_ptr<ireporter> target,
+    std::size_t capacity,
+    std::size_t memory_budget,
+    overflow_policy overflow,
+    const std::string& spill_path)
+  : _target(std::move(target)),
+    _memory_budget(memory_budget),
+    _overflow(overflow),
+    _spill_path(spill_path),
+    _slots(capacity),
+    _slot_bytes(capacity, 0)
+{
+    if (!_target) {
+        throw std::invalid_argument("async_reporter needs a reporter to forward to");
+    }
+
+    if (capacity == 0) {
+        throw std::invalid_argument("async_reporter needs a queue capacity of at least one");
+    }
+
+    if (overflow == overflow_policy::spill && spill_path.empty()) {
+        throw std::invalid_argument("async_reporter needs a file to spill events to");
+    }
+
+    _thread = std::thread(&async_reporter::run, this);
+}
+
+async_reporter::~async_reporter() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _not_empty.notify_one();
+    _thread.join();
+}
+
+void async_reporter::report(const event& e) {
+    const std::size_t bytes = footprint(e);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Once something has been spilled everything after it is spilled as
+    // well, until it has all been read back, to keep events in order.
+    if (_overflow == overflow_policy::spill && (_spill_pending > 0 || !fits(bytes))) {
+        spill(e);
+        lock.unlock();
+        _not_empty.notify_one();
+        return;
+    }
+
+    if (!fits(bytes)) {
+        if (_overflow == overflow_policy::drop_logs && !e.logs.empty()) {
+            _dropped_logs += e.logs.size();
+            if (e.type == event_type::log) {
+                return;
+            }
+
+            // Items completed in one event keep their status.
+            event without_logs = e;
+            without_logs.logs.clear();
+            const std::size_t remaining = footprint(without_logs);
+
+            ++_blocked;
+            _not_full.wait(lock, [this, remaining] { return fits(remaining); });
+            enqueue(without_logs, remaining);
+            lock.unlock();
+            _not_empty.notify_one();
+            return;
+        }
+
+        ++_blocked;
+        _not_full.wait(lock, [this, bytes] { return fits(bytes); });
+    }
+
+    enqueue(e, bytes);
+    lock.unlock();
+    _not_empty.notify_one();
+}
+
+void async_reporter::flush() {
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _drained.wait(lock, [this] { return _size == 0 && _spill_pending == 0; });
+        std::swap(error, _error);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    _target->flush();
+}
+
+bool async_reporter::flush_until(std::chrono::steady_clock::time_point deadline) {
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_drained.wait_until(lock, deadline, [this] { return _size == 0 && _spill_pending == 0; })) {
+            return false;
+        }
+        std::swap(error, _error);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    return _target->flush_until(deadline);
+}
+
+// Whatever the target still holds is older than the queue, so it is handed
+// over first, while nothing new reaches the target.
+uint64_t async_reporter::abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) {
+    const bool idle = pause(deadline);
+    uint64_t handed_over = _target->abandon(overflow, deadline);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!idle && _delivering) {
+        handed_over += hand_over_behind(overflow);
+        _paused = false;
+        return handed_over;
+    }
+
+    _overflow_target = &overflow;
+    _handed_over = 0;
+    _paused = false;
+    _not_empty.notify_one();
+
+    _drained.wait(lock, [this] { return _size == 0 && _spill_pending == 0; });
+    _overflow_target = nullptr;
+    return handed_over + _handed_over;
+}
+
+bool async_reporter::pause(std::chrono::steady_clock::time_point deadline) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _paused = true;
+    return _idle.wait_until(lock, deadline, [this] { return !_delivering; });
+}
+
+std::size_t async_reporter::pending() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size + _spill_pending;
+}
+
+void async_reporter::collect(reporter_metrics& metrics) const {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        metrics.queued += _size + _spill_pending;
+        // Queues fill up at different times, so adding up their peaks
+        // would overstate the worst any of them saw.
+        metrics.max_queued = std::max<uint64_t>(metrics.max_queued, _max_size);
+        metrics.blocked += _blocked;
+        metrics.spilled += _spilled;
+        metrics.dropped_logs += _dropped_logs;
+    }
+
+    _target->collect(metrics);
+}
+
+// Hands over everything but the event the background thread is stuck on,
+// leaving the counts as if only that one was left, so the background thread
+// finds the queue in order once it is done with it. Expects _mutex to be held
+// and the background thread to be delivering.
+uint64_t async_reporter::hand_over_behind(ireporter& overflow) {
+    uint64_t handed_over = 0;
+
+    // The stuck event is the one at the head of the queue, or a spilled one
+    // when the queue is empty.
+    const std::size_t kept_slots = _delivering_spilled ? 0 : 1;
+    const std::size_t kept_spilled = 1 - kept_slots;
+
+    for (std::size_t i = kept_slots; i < _size; ++i) {
+        const std::size_t slot = (_head + i) % _slots.size();
+        overflow.report(_slots[slot]);
+        _queued_bytes -= _slot_bytes[slot];
+        _slots[slot] = event();
+        ++handed_over;
+    }
+    _size = kept_slots;
+
+    if (_spill_pending > kept_spilled) {
+        event spilled;
+        while (_spill_reader->next(spilled)) {
+            overflow.report(spilled);
+            ++handed_over;
+        }
+        _spill_pending = kept_spilled;
+
+        // Otherwise the background thread removes the file once the stuck
+        // event is done.
+        if (_spill_pending == 0) {
+            _spill_reader.reset();
+            _spill_writer.reset();
+            std::remove(_spill_file.c_str());
+        }
+    }
+
+    _not_full.notify_all();
+    return handed_over;
+}
+
+// An empty queue takes any one event, however large, so nothing waits
+// forever. Expects _mutex to be held.
+bool async_reporter::fits(std::size_t bytes) const {
+    if (_size == _slots.size()) {
+        return false;
+    }
+
+    return _memory_budget == 0 || _size == 0 || _queued_bytes + bytes <= _memory_budget;
+}
+
+// Expects _mutex to be held.
+void async_reporter::enqueue(const event& e, std::size_t bytes) {
+    const std::size_t slot = (_head + _size) % _slots.size();
+    _slots[slot] = e;
+    _slot_bytes[slot] = bytes;
+    _queued_bytes += bytes;
+
+    ++_size;
+    if (_size > _max_size) {
+        _max_size = _size;
+    }
+}
+
+// Expects _mutex to be held. The journal is flushed after every event so the
+// background thread only ever reads complete records.
+void async_reporter::spill(const event& e) {
+    if (!_spill_writer) {
+        _spill_file = unused_path(_spill_path);
+        _spill_writer = std::make_unique<journal_writer>(_spill_file);
+        _spill_writer->flush();
+        _spill_reader = std::make_unique<journal_reader>(_spill_file);
+    }
+
+    _spill_writer->report(e);
+    _spill_writer->flush();
+    ++_spill_pending;
+    ++_spilled;
+}
+
+void async_reporter::deliver(const event& e, ireporter* overflow) {
+    try {
+        if (overflow) {
+            overflow->report(e);
+        } else {
+            _target->report(e);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> error_lock(_mutex);
+        if (!_error) {
+            _error = std::current_exception();
+        }
+    }
+}
+
+void async_reporter::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _not_empty.wait(lock, [this] {
+            return (!_paused && (_size > 0 || _spill_pending > 0)) || _stopping;
+        });
+
+        _delivering = true;
+
+        if (_size > 0) {
+            // The slot stays counted in _size until it has been reported so the
+            // producer can not overwrite it while we are still reading from it.
+            event& e = _slots[_head];
+            const std::size_t bytes = _slot_bytes[_head];
+            ireporter* const overflow = _overflow_target;
+            _delivering_spilled = false;
+            lock.unlock();
+
+            deliver(e, overflow);
+            if (_memory_budget > 0 && bytes > _memory_budget / _slots.size()) {
+                e = event();
+            }
+
+            lock.lock();
+            _head = (_head + 1) % _slots.size();
+            --_size;
+            _queued_bytes -= bytes;
+            if (overflow) {
+                ++_handed_over;
+            }
+        } else if (_spill_pending > 0) {
+            // Everything spilled is newer than what was queued, so it is read
+            // back only once the queue is empty.
+            ireporter* const overflow = _overflow_target;
+            _delivering_spilled = true;
+            lock.unlock();
+
+            const bool complete = _spill_reader->next(_unspilled);
+            if (complete) {
+                deliver(_unspilled, overflow);
+            }
+
+            lock.lock();
+            if (complete && overflow) {
+                ++_handed_over;
+            }
+            if (!complete) {
+                if (!_error) {
+                    _error = std::make_exception_ptr(std::runtime_error("Unable to read back spilled events"));
+                }
+                _spill_pending = 0;
+            } else {
+                --_spill_pending;
+            }
+
+            if (_spill_pending == 0) {
+                _spill_reader.reset();
+                _spill_writer.reset();
+                std::remove(_spill_file.c_str());
+            }
+        } else {
+            return;
+        }
+
+        _delivering = false;
+        if (_paused) {
+            _idle.notify_all();
+        }
+
+        _not_full.notify_one();
+        if (_size == 0 && _spill_pending == 0) {
+            _drained.notify_all();
+        }
+    }
+}
+
+}
+}
@@ -1,36 +1,519 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
 #include <gtest/gtest.h>
 #include <reportportal/gtest/event_listener.hpp>
+#include <reportportal/gtest/async_reporter.hpp>
+#include <reportportal/gtest/journal.hpp>
+#include <reportportal/gtest/log_batcher.hpp>
+#include <reportportal/gtest/retrying_reporter.hpp>
+#include <reportportal/gtest/sender_pool.hpp>
+#include <reportportal/gtest/service_reporter.hpp>
 
 namespace reportportal
 {
 namespace gtest
 {
 
-static std::string char_to_string(const char* char_array)
+namespace
+{
+
+// Takes the events left over at the flush deadline when there is no spool.
+class discarding_reporter : public ireporter
+{
+    public:
+        void report(const event& e) override {}
+        void flush() override {}
+};
+
+}
+
+// Appends a C string that gtest may have left null.
+static void append(std::string& buffer, const char* value)
+{
+    if (value) {
+        buffer.append(value);
+    }
+}
+
+// Appends the decimal representation of value without a temporary string.
+template <typename Integer>
+static void append(std::string& buffer, Integer value)
+{
+    char digits[std::numeric_limits<Integer>::digits10 + 2];
+    const std::to_chars_result result = std::to_chars(std::begin(digits), std::end(digits), value);
+    buffer.append(digits, result.ptr);
+}
+
+// Appends at most limit bytes of message, cut at a character boundary, and a
+// note of how many were left out. Zero appends it whole.
+static void append_limited(std::string& buffer, const char* message, std::size_t limit)
+{
+    if (!message) {
+        return;
+    }
+
+    const std::size_t size = std::strlen(message);
+    if (limit == 0 || size <= limit) {
+        buffer.append(message, size);
+        return;
+    }
+
+    std::size_t cut = limit;
+    while (cut > 0 && (static_cast<unsigned char>(message[cut]) & 0xc0) == 0x80) {
+        --cut;
+    }
+
+    buffer.append(message, cut);
+    buffer += "\n... ";
+    append(buffer, size - cut);
+    buffer += " more bytes left out";
+}
+
+// gtest keeps timestamps as milliseconds since the system clock's epoch.
+static std::chrono::system_clock::time_point to_time_point(::testing::TimeInMillis gtime)
+{
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(gtime));
+}
+
+// and durations as milliseconds.
+static std::chrono::milliseconds to_duration(::testing::TimeInMillis gtime)
+{
+    return std::chrono::milliseconds(gtime);
+}
+
+static std::unique_ptr<ireporter> make_reporter(report_portal::iservice& service, const listener_options& options)
+{
+    std::unique_ptr<ireporter> reporter;
+    if (options.spool_path.empty()) {
+        reporter = std::make_unique<service_reporter>(service, options.concurrent_requests);
+        if (options.retry.attempts > 1 || options.retry.breaker_threshold > 0) {
+            reporter = std::make_unique<retrying_reporter>(std::move(reporter), options.retry);
+        }
+        if (options.sender_threads > 1) {
+            reporter = std::make_unique<sender_pool>(
+                std::move(reporter),
+                options.sender_threads,
+                options.queue_capacity,
+                options.queue_memory_budget,
+                options.overflow,
+                options.overflow_path);
+        }
+    } else {
+        reporter = std::make_unique<journal_writer>(options.spool_path);
+    }
+
+    if (options.asynchronous) {
+        reporter = std::make_unique<async_reporter>(
+            std::move(reporter),
+            options.queue_capacity,
+            options.queue_memory_budget,
+            options.overflow,
+            options.overflow_path);
+    }
+
+    if (options.batch_logs) {
+        reporter = std::make_unique<log_batcher>(
+            std::move(reporter),
+            options.log_batch_entries,
+            options.log_batch_bytes,
+            options.log_batch_delay);
+    }
+
+    return reporter;
+}
+
+event_listener::event_listener(report_portal::iservice& service, const listener_options& options)
+  : event_listener(make_reporter(service, options), options)
+{
+    if (options.flush_deadline.count() != 0) {
+        throw std::invalid_argument("event_listener needs to own the service to give up on it at the flush deadline");
+    }
+}
+
+event_listener::event_listener(std::unique_ptr<report_portal::iservice> service, const listener_options& options)
+  : event_listener(make_reporter(*service, options), options)
+{
+    _service = std::move(service);
+}
+
+event_listener::event_listener(std::unique_ptr<ireporter> reporter, const listener_options& options)
+  : _reporter(std::move(reporter)),
+    _root_name("Google Test Suite"),
+    _metrics_path(options.metrics_path),
+    _print_metrics(options.print_metrics),
+    _flush_deadline(options.flush_deadline),
+    _flush_spool_path(options.flush_spool_path),
+    _defer_tests((options.defer_tests || options.summarize_passes) && !options.aggregate_repeats),
+    _aggregate_repeats(options.aggregate_repeats),
+    _summarize_passes(options.summarize_passes && !options.aggregate_repeats),
+    _log_message_limit(options.log_message_limit),
+    _capture_output(options.capture_output),
+    _capture_head_bytes(options.capture_head_bytes),
+    _capture_tail_bytes(options.capture_tail_bytes),
+    _test_logs(options.test_log_capacity)
+{
+    set_log_ring(&_test_logs);
+
+    if (!options.launch_uuid.empty()) {
+        _launch_uuid = uuids::uuid::from_string(options.launch_uuid);
+        if (_launch_uuid.is_nil()) {
+            throw std::invalid_argument("Invalid launch uuid " + options.launch_uuid);
+        }
+
+        // Joined launches are left to whoever was told to finish them.
+        _finish_launch = options.finish_launch;
+    }
+
+    if (options.total_shards > 1) {
+        _root_name += " (shard ";
+        append(_root_name, options.shard_index + 1);
+        _root_name += " of ";
+        append(_root_name, options.total_shards);
+        _root_name += ")";
+    }
+}
+
+// The listener formats everything into _event and _log_event, clearing rather
+// than recreating them, so once their strings have grown large enough reporting
+// an event does not allocate on the test thread.
+event& event_listener::reset_event(event_type type) {
+    _event.type = type;
+    _event.item = null_handle;
+    _event.parent = null_handle;
+    _event.time = std::chrono::system_clock::now();
+    _event.name.clear();
+    _event.description.clear();
+    _event.item_type = report_portal::test_item_type::suite;
+    _event.status = report_portal::test_item_status::inherit;
+    _event.rerun_of = uuids::uuid();
+    return _event;
+}
+
+void event_listener::report(const event& e) {
+    ++_metrics.events;
+    _metrics.log_entries += e.logs.size();
+    _metrics.bytes_reported += e.name.size() + e.description.size();
+    for (const log_entry& entry : e.logs) {
+        _metrics.bytes_reported += entry.message.size();
+    }
+
+    _reporter->report(e);
+}
+
+void event_listener::begin_item(report_portal::test_item_type type) {
+    _event.item = ++_next_handle;
+    _event.parent = _test_item_stack.empty() ? _launch_handle : _test_item_stack.back().item;
+    _event.item_type = type;
+
+    if (_defer_tests && type == report_portal::test_item_type::step) {
+        // Assigning reuses the strings' memory from the previous test.
+        _deferred.item = _event.item;
+        _deferred.parent = _event.parent;
+        _deferred.time = _event.time;
+        _deferred.name = _event.name;
+        _deferred.description = _event.description;
+        _deferred.item_type = _event.item_type;
+        _deferred.logs.clear();
+    } else {
+        report(_event);
+    }
+
+    _test_item_stack.push_back(running_item{_event.item, _event.time, _event.time});
+}
+
+void event_listener::end_item(std::chrono::system_clock::time_point end, report_portal::test_item_status status) {
+    const running_item& ending = _test_item_stack.back();
+
+    event& e = reset_event(event_type::end_item);
+    e.item = ending.item;
+    e.time = std::max(end, ending.children_end);
+    e.status = status;
+    report(e);
+
+    pop_item(e.time);
+}
+
+// Reports the deferred test, whose logs are already in _deferred.logs.
+void event_listener::complete_item(std::chrono::system_clock::time_point end, report_portal::test_item_status status) {
+    const running_item& ending = _test_item_stack.back();
+
+    _deferred.type = event_type::complete_item;
+    _deferred.end_time = std::max(end, ending.children_end);
+    _deferred.status = status;
+    report(_deferred);
+
+    pop_item(_deferred.end_time);
+}
+
+void event_listener::pop_item(std::chrono::system_clock::time_point end) {
+    _test_item_stack.pop_back();
+    if (!_test_item_stack.empty()) {
+        _test_item_stack.back().children_end = std::max(_test_item_stack.back().children_end, end);
+    }
+}
+
+// Items end when gtest says they took elapsed after they began, so the time the
+// listener and reporters spend on them is not counted.
+std::chrono::system_clock::time_point event_listener::end_after(std::chrono::milliseconds elapsed) const {
+    return _test_item_stack.back().begin + elapsed;
+}
+
+// A deferred test carries its logs along, as does an iteration of an
+// aggregated test until it is known to have failed; anything else, such as a
+// suite failing in SetUpTestSuite, is logged to right away.
+bool event_listener::logs_deferred() const {
+    return (_defer_tests || _aggregate_repeats) && _test_item_stack.back().item == _deferred.item;
+}
+
+// Starts an entry for the running item, stamped with the current time. Resizing
+// to one keeps the entry, and the memory of its message, from the last time.
+log_entry& event_listener::begin_log_entry() {
+    log_entry* entry = nullptr;
+    if (logs_deferred()) {
+        entry = &_deferred.logs.emplace_back();
+    } else {
+        _log_event.logs.resize(1);
+        entry = &_log_event.logs[0];
+    }
+
+    entry->item = _test_item_stack.back().item;
+    entry->time = std::chrono::system_clock::now();
+    return *entry;
+}
+
+// Reports the entry begun last, unless it waits for its deferred test.
+void event_listener::end_log_entry() {
+    if (!logs_deferred()) {
+        _log_event.type = event_type::log;
+        report(_log_event);
+    }
+}
+
+event_listener::~event_listener() {
+    _test_logs.uninstall();
+
+    // A request given up on at the flush deadline may still be on its way,
+    // and destroying the reporter would wait for it.
+    if (_gave_up) {
+        _reporter.release();
+        _service.release();
+    }
+}
+
+// Pops entries into the logs that are reported next, reusing the entries, and
+// the memory of their messages, already there. Expects _mutex to be held.
+void event_listener::drain_test_logs() {
+    if (_test_item_stack.empty()) {
+        return;
+    }
+
+    const item_handle item = _test_item_stack.back().item;
+    const bool deferred = logs_deferred();
+    std::vector<log_entry>& logs = deferred ? _deferred.logs : _log_event.logs;
+
+    const std::size_t first = deferred ? logs.size() : 0;
+    std::size_t count = first;
+    while (true) {
+        if (count == logs.size()) {
+            logs.emplace_back();
+        }
+        if (!_test_logs.pop(logs[count])) {
+            break;
+        }
+        logs[count++].item = item;
+    }
+    logs.resize(count);
+
+    if (!deferred && count > first) {
+        _log_event.type = event_type::log;
+        report(_log_event);
+    }
+}
+
+// Logs the output of the test that is ending, whole or with its middle
+// skipped, as an entry of its own.
+void event_listener::log_output() {
+    const uint64_t written = _output->take(_output_text);
+    if (written == 0) {
+        return;
+    }
+
+    log_entry& entry = begin_log_entry();
+    entry.level = report_portal::log_level::info;
+    entry.message = "Output of the test, ";
+    append(entry.message, written);
+    entry.message += " bytes";
+    if (written > _capture_head_bytes + _capture_tail_bytes) {
+        entry.message += " of which the beginning and end are kept";
+    }
+    entry.message += ":\n";
+    entry.message += _output_text;
+    end_log_entry();
+}
+
+// Reports the beginning of a test.
+void event_listener::begin_test(const ::testing::TestInfo& test_info) {
+    event& e = reset_event(event_type::begin_item);
+    append(e.name, test_info.name());
+
+    e.description = "type_param = ";
+    append(e.description, test_info.type_param());
+    e.description += "\nvalue_param = ";
+    append(e.description, test_info.value_param());
+    e.description += "\nfile = ";
+    append(e.description, test_info.file());
+    e.description += "\nline = ";
+    append(e.description, test_info.line());
+    e.description += "\n";
+
+    begin_item(report_portal::test_item_type::step);
+    aggregate_item(&test_info, true);
+}
+
+// In aggregate_repeats mode a suite or test that ran in an earlier iteration
+// runs again as the item reported then, without reporting anything. Returns
+// whether it did.
+bool event_listener::resume_item(const void* key) {
+    if (!_aggregate_repeats) {
+        return false;
+    }
+
+    const auto found = _aggregated_index.find(key);
+    if (found == _aggregated_index.end()) {
+        return false;
+    }
+
+    const std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+    _test_item_stack.push_back(running_item{_aggregated[found->second].item, now, now});
+    return true;
+}
+
+// Keeps the item begun last for the iterations to come.
+void event_listener::aggregate_item(const void* key, bool test) {
+    if (_aggregate_repeats) {
+        _aggregated_index.emplace(key, _aggregated.size());
+        _aggregated.push_back(aggregated_item{_test_item_stack.back().item, test, {}, {}});
+    }
+}
+
+// Ends an iteration of an aggregated suite or test without reporting its end.
+void event_listener::leave_item(
+    const void* key,
+    std::chrono::system_clock::time_point end,
+    report_portal::test_item_status status,
+    std::chrono::milliseconds elapsed)
 {
-    return char_array ? char_array : "";
+    aggregated_item& leaving = _aggregated[_aggregated_index.at(key)];
+    end = std::max(end, _test_item_stack.back().children_end);
+    leaving.end = std::max(leaving.end, end);
+    if (leaving.test) {
+        leaving.statistics.record(status, elapsed);
+    }
+
+    pop_item(end);
+}
+
+// Ends the aggregated items, each test with a log of its statistics. Tests
+// end first, so that no suite ends before its tests do.
+void event_listener::end_aggregated_items() {
+    for (const bool tests : {true, false}) {
+        for (const aggregated_item& ending : _aggregated) {
+            if (ending.test != tests) {
+                continue;
+            }
+
+            event& e = reset_event(event_type::end_item);
+            e.item = ending.item;
+            e.time = ending.end;
+
+            if (ending.test) {
+                _log_event.logs.resize(1);
+                log_entry& entry = _log_event.logs[0];
+                entry.item = ending.item;
+                entry.time = ending.end;
+                entry.level = report_portal::log_level::info;
+                entry.message.clear();
+                ending.statistics.describe(entry.message);
+                _log_event.type = event_type::log;
+                report(_log_event);
+
+                e.status = ending.statistics.status();
+            }
+
+            report(e);
+        }
+    }
+}
+
+// Counts a passing test, already popped, into the summary of its suite.
+void event_listener::summarize_pass(const ::testing::TestInfo& test_info, std::chrono::milliseconds elapsed) {
+    ++_passed_count;
+    _passed_duration += elapsed;
+
+    append(_passed_tests, test_info.name());
+    _passed_tests += '\t';
+    append(_passed_tests, elapsed.count());
+    _passed_tests += " ms\n";
 }
 
-event_listener::event_listener(report_portal::service& service)
-  : _service(service)
-{}
+// Logs the summary of the passing tests to the suite that is ending, followed
+// by the list of them.
+void event_listener::log_passed_tests() {
+    log_entry& entry = begin_log_entry();
+    entry.level = report_portal::log_level::info;
+    entry.message = "Passed tests: ";
+    append(entry.message, _passed_count);
+    entry.message += ", ";
+    append(entry.message, _passed_duration.count());
+    entry.message += " ms in total\n";
+    entry.message += _passed_tests;
+    end_log_entry();
+
+    _passed_tests.clear();
+    _passed_count = 0;
+    _passed_duration = std::chrono::milliseconds::zero();
+}
 
 // Fired before any test activity starts.
 void event_listener::OnTestProgramStart(const ::testing::UnitTest& unit_test) {
-    _launch = std::make_unique<report_portal::launch>(_service, "Google Test Launch");
-    _launch->set_description("This is a test launch for google tests.");
+    scoped_latency latency(_metrics.hook(listener_hook::test_program_start));
 
-    _launch->start(std::chrono::high_resolution_clock::now());
+    event& launch = reset_event(event_type::begin_launch);
+    if (unit_test.start_timestamp() > 0) {
+        launch.time = to_time_point(unit_test.start_timestamp());
+    }
+    launch.item = _launch_handle = ++_next_handle;
+    launch.name = "Google Test Launch";
+    launch.description = "This is a test launch for google tests.";
+    launch.rerun_of = _launch_uuid;
+    report(launch);
+
+    if (_capture_output) {
+        _output = std::make_unique<output_capture>(_capture_head_bytes, _capture_tail_bytes);
+    }
 
-    std::unique_ptr<report_portal::test_item> suite = std::make_unique<report_portal::test_item>(*_launch, "Google Test Suite");
-    suite->start(std::chrono::high_resolution_clock::now());
-    _test_item_stack.push_back(std::move(suite));
+    const std::chrono::system_clock::time_point launch_time = launch.time;
+    event& root = reset_event(event_type::begin_item);
+    root.time = launch_time;
+    root.name = _root_name;
+    begin_item(report_portal::test_item_type::suite);
 }
 
 // Fired before each iteration of tests starts.  There may be more than
 // one iteration if GTEST_FLAG(repeat) is set. iteration is the iteration
 // index, starting from 0.
 void event_listener::OnTestIterationStart(const ::testing::UnitTest& unit_test, int iteration) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _iteration = iteration;
 }
 
 // Fired before environment set-up for each iteration of tests starts.
@@ -43,51 +526,93 @@ void event_listener::OnEnvironmentsSetUpEnd(const ::testing::UnitTest& unit_test
 
 // Fired before the test suite starts.
 void event_listener::OnTestSuiteStart(const ::testing::TestSuite& test_suite) {
-    std::unique_ptr<report_portal::test_item>& suite = _test_item_stack.back();
-
-    const std::string name = char_to_string(test_suite.name());
-    const std::string type_param = char_to_string(test_suite.type_param());
+    std::lock_guard<std::mutex> lock(_mutex);
+    scoped_latency latency(_metrics.hook(listener_hook::test_suite_start));
+    drain_test_logs();
+    if (resume_item(&test_suite)) {
+        return;
+    }
 
-    std::unique_ptr<report_portal::test_item> test_suite_item = std::make_unique<report_portal::test_item>(*suite, name, report_portal::test_item_type::suite);
-    test_suite_item->set_description("type_param = " + type_param);
+    event& e = reset_event(event_type::begin_item);
+    append(e.name, test_suite.name());
+    e.description = "type_param = ";
+    append(e.description, test_suite.type_param());
 
-    test_suite_item->start(std::chrono::high_resolution_clock::now());
-    _test_item_stack.push_back(std::move(test_suite_item));
+    begin_item(report_portal::test_item_type::suite);
+    aggregate_item(&test_suite, false);
 }
 
 // Fired before the test starts.
 void event_listener::OnTestStart(const ::testing::TestInfo& test_info) {
-    std::unique_ptr<report_portal::test_item>& test_suite = _test_item_stack.back();
+    std::lock_guard<std::mutex> lock(_mutex);
+    scoped_latency latency(_metrics.hook(listener_hook::test_start));
+    drain_test_logs();
+    if (!resume_item(&test_info)) {
+        begin_test(test_info);
+    }
 
-    const std::string name = char_to_string(test_info.name());
-    const std::string type_param = char_to_string(test_info.type_param());
-    const std::string value_param = char_to_string(test_info.value_param());
-    const std::string file = char_to_string(test_info.file());
-    const std::string line = std::to_string(test_info.line());
+    if (_aggregate_repeats) {
+        // The iteration's logs wait until it is known to have failed.
+        _deferred.item = _test_item_stack.back().item;
+        _deferred.logs.clear();
 
-    std::unique_ptr<report_portal::test_item> test = std::make_unique<report_portal::test_item>(*test_suite, name, report_portal::test_item_type::step);
-    test->set_description(
-        "type_param = " + type_param + "\n"
-        "value_param = " + value_param + "\n"
-        "file = " + file + "\n"
-        "line = " + line + "\n");
+        log_entry& entry = begin_log_entry();
+        entry.level = report_portal::log_level::info;
+        entry.message = "Iteration ";
+        append(entry.message, _iteration + 1);
+        end_log_entry();
+    }
 
-    test->start(std::chrono::high_resolution_clock::now());
-    _test_item_stack.push_back(std::move(test));
+    if (_output) {
+        _output->restart();
+    }
 }
 
 // Fired after a failed assertion or a SUCCEED() invocation.
 // If you want to throw an exception from this function to skip to the next
 // TEST, it must be AssertionException defined above, or inherited from it.
+//
+// Each result is logged as it happens rather than when the test ends, so long
+// tests show their failures early and a test with many of them does not send
+// them all at once. gtest calls this on whichever thread made the assertion.
 void event_listener::OnTestPartResult(const ::testing::TestPartResult& test_part_result) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    scoped_latency latency(_metrics.hook(listener_hook::test_part_result));
+    if (_test_item_stack.empty()) {
+        return;
+    }
+
+    drain_test_logs();
+
+    scoped_latency log_latency(_metrics.hook(listener_hook::log));
+
+    log_entry& entry = begin_log_entry();
+    entry.level = report_portal::log_level::error;
+
+    entry.message = "file = ";
+    append(entry.message, test_part_result.file_name());
+    entry.message += "\nline = ";
+    append(entry.message, test_part_result.line_number());
+    entry.message += "\n";
+    // Unlike the summary the full message includes the stack trace.
+    append_limited(entry.message, test_part_result.message(), _log_message_limit);
+    end_log_entry();
 }
 
 // Fired after the test ends.
 void event_listener::OnTestEnd(const ::testing::TestInfo& test_info) {
-    std::unique_ptr<report_portal::test_item>& test = _test_item_stack.back();
+    std::lock_guard<std::mutex> lock(_mutex);
+    scoped_latency latency(_metrics.hook(listener_hook::test_end));
+    drain_test_logs();
 
     report_portal::test_item_status status = report_portal::test_item_status::skipped;
     const ::testing::TestResult* test_result = test_info.result();
+    const std::chrono::milliseconds elapsed = test_result
+        ? to_duration(test_result->elapsed_time())
+        : std::chrono::milliseconds::zero();
+    const std::chrono::system_clock::time_point end = test_result
+        ? end_after(elapsed)
+        : std::chrono::system_clock::now();
     if (test_result) {
         if (test_result->Passed()) {
             status = report_portal::test_item_status::passed;
@@ -96,32 +621,46 @@ void event_listener::OnTestEnd(const ::testing::TestInfo& test_info) {
         } else {
             status = report_portal::test_item_status::failed;
         }
+    }
 
-        for (int i = 0; i < test_result->total_part_count(); ++i) {
-            const ::testing::TestPartResult& test_part_result = test_result->GetTestPartResult(i);
-
-            const std::string file_name = char_to_string(test_part_result.file_name());
-            const std::string line_number = std::to_string(test_part_result.line_number());
-            const std::string summary = char_to_string(test_part_result.summary());
-            const std::string message = char_to_string(test_part_result.message());
+    if (_output && status == report_portal::test_item_status::failed) {
+        log_output();
+    }
 
-            const std::string detailed_log =
-                "file = " + file_name + "\n"
-                "line = " + line_number + "\n" + summary;
-            test->log(std::chrono::high_resolution_clock::now(), report_portal::log_level::error, detailed_log);
+    if (_aggregate_repeats) {
+        if (status == report_portal::test_item_status::failed) {
+            _deferred.type = event_type::log;
+            report(_deferred);
         }
-    }
 
-    test->end(std::chrono::high_resolution_clock::now(), status);
-    _test_item_stack.pop_back();
+        leave_item(&test_info, end, status, elapsed);
+    } else if (_summarize_passes && status == report_portal::test_item_status::passed) {
+        pop_item(end);
+        summarize_pass(test_info, elapsed);
+    } else if (_defer_tests) {
+        complete_item(end, status);
+    } else {
+        end_item(end, status);
+    }
 }
 
 // Fired after the test suite ends.
 void event_listener::OnTestSuiteEnd(const ::testing::TestSuite& test_suite) {
-    std::unique_ptr<report_portal::test_item>& test_suite_item = _test_item_stack.back();
+    std::lock_guard<std::mutex> lock(_mutex);
+    scoped_latency latency(_metrics.hook(listener_hook::test_suite_end));
+    drain_test_logs();
 
-    test_suite_item->end(std::chrono::high_resolution_clock::now());
-    _test_item_stack.pop_back();
+    const std::chrono::system_clock::time_point end = end_after(to_duration(test_suite.elapsed_time()));
+    if (_aggregate_repeats) {
+        leave_item(&test_suite, end, report_portal::test_item_status::inherit, std::chrono::milliseconds::zero());
+    } else if (_passed_count > 0) {
+        // The passing tests are not there for the suite to take its status
+        // from.
+        log_passed_tests();
+        end_item(end, test_suite.Failed() ? report_portal::test_item_status::failed : report_portal::test_item_status::passed);
+    } else {
+        end_item(end);
+    }
 }
 
 // Fired before environment tear-down for each iteration of tests starts.
@@ -138,12 +677,128 @@ void event_listener::OnTestIterationEnd(const ::testing::UnitTest& unit_test, in
 
 // Fired after all test activities have ended.
 void event_listener::OnTestProgramEnd(const ::testing::UnitTest& unit_test) {
-    std::unique_ptr<report_portal::test_item>& suite = _test_item_stack.back();
-    suite->end(std::chrono::high_resolution_clock::now());
-    _test_item_stack.pop_back();
+    // The metrics matter most when reporting failed, so they are exported
+    // before the error is passed on.
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        scoped_latency latency(_metrics.hook(listener_hook::test_program_end));
+        try {
+            drain_test_logs();
+            _output.reset();
+            end_aggregated_items();
+
+            // With GTEST_FLAG(repeat) gtest only times the last iteration, so
+            // the program ends now.
+            end_item(std::chrono::system_clock::now());
+
+            event& launch = reset_event(_finish_launch ? event_type::end_launch : event_type::leave_launch);
+            launch.item = _launch_handle;
+            report(launch);
+            _launch_handle = null_handle;
+
+            // In asynchronous mode this is where the test program waits for
+            // the background thread to catch up before exiting.
+            flush();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    const uint64_t dropped_logs = _test_logs.dropped();
+    if (dropped_logs > 0) {
+        std::cerr << "ReportPortal: dropped " << dropped_logs
+                  << " entries logged with reportportal::gtest::log" << std::endl;
+    }
+
+    export_metrics();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
 
-    _launch->end(std::chrono::high_resolution_clock::now());
-    _launch.reset();
+// Waits for the reporter to deliver everything, reporting progress on stderr
+// once a second, but gives up on what is left at the flush deadline.
+void event_listener::flush() {
+    if (_flush_deadline.count() == 0) {
+        _reporter->flush();
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + _flush_deadline;
+    while (true) {
+        const std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        if (_reporter->flush_until(std::min(deadline, next))) {
+            return;
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            abandon(deadline);
+            return;
+        }
+
+        reporter_metrics progress;
+        _reporter->collect(progress);
+        std::cerr << "ReportPortal: waiting for " << progress.queued << " events to be delivered" << std::endl;
+    }
+}
+
+// The deadline has passed by now, so an event still on its way to the server
+// is given up on rather than waited for.
+void event_listener::abandon(std::chrono::steady_clock::time_point deadline) {
+    _gave_up = true;
+    if (_flush_spool_path.empty()) {
+        discarding_reporter discard;
+        _metrics.unflushed_events = _reporter->abandon(discard, deadline);
+        std::cerr << "ReportPortal: dropped " << _metrics.unflushed_events
+                  << " events not delivered by the deadline" << std::endl;
+        return;
+    }
+
+    const std::string path = unused_path(_flush_spool_path);
+    {
+        journal_writer spool(path);
+        _metrics.unflushed_events = _reporter->abandon(spool, deadline);
+    }
+
+    if (_metrics.unflushed_events == 0) {
+        // Only the running items were written, nothing that needs them.
+        std::remove(path.c_str());
+        std::cerr << "ReportPortal: no events were left to write by the deadline" << std::endl;
+    } else {
+        std::cerr << "ReportPortal: wrote " << _metrics.unflushed_events
+                  << " events not delivered by the deadline to " << path << std::endl;
+    }
+}
+
+listener_metrics event_listener::metrics() const {
+    listener_metrics metrics = _metrics;
+    metrics.dropped_test_logs = _test_logs.dropped();
+    _reporter->collect(metrics.reporter);
+    return metrics;
+}
+
+void event_listener::export_metrics() const {
+    if (_metrics_path.empty() && !_print_metrics) {
+        return;
+    }
+
+    // The tests have run by now, so a metrics file that can not be written
+    // is no reason to fail the program.
+    const listener_metrics current = metrics();
+    if (!_metrics_path.empty()) {
+        std::ofstream out(_metrics_path);
+        current.write_json(out);
+        out << "\n";
+        if (!out) {
+            std::cerr << "ReportPortal: unable to write metrics to " << _metrics_path << std::endl;
+        }
+    }
+
+    if (_print_metrics) {
+        current.write_text(std::cout);
+    }
 }
 }
 }
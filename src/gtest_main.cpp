@@ -4,6 +4,7 @@
 #include <iostream>
 #include <chrono>
 #include <ctime>
+#include <memory>
 #include <reportportal/gtest/event_listener.hpp>
 
 namespace test {
@@ -526,7 +527,8 @@ int main(int argc, char **argv)
     ::testing::InitGoogleTest(&argc, argv);
     ::testing::TestEventListeners& listeners = ::testing::UnitTest::GetInstance()->listeners();
     // delete listeners.Release(listeners.default_result_printer());
-    report_portal::service service("http://web.demo.reportportal.io", "DEFAULT_PERSONAL", "default", "1q2w3e");
-    listeners.Append(new reportportal::gtest::event_listener(service));
+    auto service = std::make_unique<report_portal::service>(
+        "http://web.demo.reportportal.io", "DEFAULT_PERSONAL", "default", "1q2w3e");
+    listeners.Append(new reportportal::gtest::event_listener(std::move(service)));
     return RUN_ALL_TESTS();
 }
@@ -0,0 +1,300 @@
+#include <reportportal/gtest/journal.hpp>
+
+#include <stdexcept>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+namespace
+{
+
+const std::string journal_magic = "RPGTJRNL";
+// Version 2 added the launch to rerun, version 3 the end of completed items.
+const char journal_version = 3;
+
+// No event comes close; a longer record means the journal is corrupt, and
+// reading it would only run out of memory.
+const uint64_t max_record_size = 64 * 1024 * 1024;
+
+void put_varint(std::string& buffer, uint64_t value)
+{
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+void put_string(std::string& buffer, const std::string& value)
+{
+    put_varint(buffer, value.size());
+    buffer.append(value);
+}
+
+void put_time(std::string& buffer, const std::chrono::system_clock::time_point& time)
+{
+    const int64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+
+    // Zig-zag encode so times before the epoch stay short as well.
+    put_varint(buffer, (static_cast<uint64_t>(micros) << 1) ^ static_cast<uint64_t>(micros >> 63));
+}
+
+class payload_reader
+{
+    public:
+        explicit payload_reader(const std::string& payload)
+          : _payload(payload)
+        {}
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const uint8_t byte = static_cast<uint8_t>(get());
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+
+            throw std::runtime_error("Journal contains a malformed integer");
+        }
+
+        uint8_t byte() {
+            return static_cast<uint8_t>(get());
+        }
+
+        void string(std::string& value) {
+            const uint64_t size = varint();
+            if (size > _payload.size() - _position) {
+                throw std::runtime_error("Journal contains a truncated string");
+            }
+
+            value.assign(_payload, _position, size);
+            _position += size;
+        }
+
+        std::size_t remaining() const {
+            return _payload.size() - _position;
+        }
+
+        std::chrono::system_clock::time_point time() {
+            const uint64_t encoded = varint();
+            const int64_t micros = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+            return std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds(micros)));
+        }
+
+    private:
+        char get() {
+            if (_position >= _payload.size()) {
+                throw std::runtime_error("Journal record ends unexpectedly");
+            }
+
+            return _payload[_position++];
+        }
+
+        const std::string& _payload;
+        std::size_t _position = 0;
+};
+
+}
+
+// Events are only ever appended to a journal of the version written here, as
+// a reader would take them to be in the format of the header.
+journal_writer::journal_writer(const std::string& path)
+{
+    std::ifstream existing(path, std::ios::binary | std::ios::ate);
+    const bool empty = existing.tellg() <= 0;
+    if (!empty) {
+        std::string magic(journal_magic.size(), '\0');
+        existing.seekg(0);
+        existing.read(&magic[0], magic.size());
+        const int version = existing.get();
+        if (!existing || magic != journal_magic) {
+            throw std::runtime_error(path + " is not a journal");
+        }
+
+        if (version != journal_version) {
+            throw std::runtime_error(
+                "Unable to append to journal " + path + " of version " + std::to_string(version)
+                + ", remove it or replay it first");
+        }
+    }
+    existing.close();
+
+    _file.open(path, std::ios::binary | std::ios::app);
+    if (!_file) {
+        throw std::runtime_error("Unable to open journal " + path);
+    }
+
+    if (empty) {
+        _file.write(journal_magic.data(), journal_magic.size());
+        _file.put(journal_version);
+        _bytes_written += journal_magic.size() + 1;
+    }
+}
+
+void journal_writer::report(const event& e) {
+    _payload.clear();
+    _payload.push_back(static_cast<char>(e.type));
+    put_varint(_payload, e.item);
+    put_varint(_payload, e.parent);
+    put_time(_payload, e.time);
+    put_string(_payload, e.name);
+    put_string(_payload, e.description);
+    _payload.push_back(static_cast<char>(e.item_type));
+    _payload.push_back(static_cast<char>(e.status));
+
+    put_varint(_payload, e.logs.size());
+    for (const log_entry& entry : e.logs) {
+        put_varint(_payload, entry.item);
+        put_time(_payload, entry.time);
+        _payload.push_back(static_cast<char>(entry.level));
+        put_string(_payload, entry.message);
+    }
+
+    put_string(_payload, e.rerun_of.is_nil() ? std::string() : uuids::to_string(e.rerun_of));
+    put_time(_payload, e.end_time);
+
+    _record.clear();
+    put_varint(_record, _payload.size());
+    _record.append(_payload);
+
+    _file.write(_record.data(), _record.size());
+    if (!_file) {
+        throw std::runtime_error("Unable to append to journal");
+    }
+
+    _bytes_written += _record.size();
+}
+
+void journal_writer::flush() {
+    _file.flush();
+}
+
+uint64_t journal_writer::bytes_written() const {
+    return _bytes_written;
+}
+
+void journal_writer::collect(reporter_metrics& metrics) const {
+    metrics.bytes_written += _bytes_written;
+}
+
+journal_reader::journal_reader(const std::string& path)
+  : _file(path, std::ios::binary)
+{
+    if (!_file) {
+        throw std::runtime_error("Unable to open journal " + path);
+    }
+
+    std::string magic(journal_magic.size(), '\0');
+    _file.read(&magic[0], magic.size());
+    _version = _file.get();
+    if (!_file || magic != journal_magic) {
+        throw std::runtime_error(path + " is not a journal");
+    }
+
+    if (_version < 1 || _version > journal_version) {
+        throw std::runtime_error("Unsupported journal version " + std::to_string(_version));
+    }
+}
+
+bool journal_reader::next(event& e) {
+    uint64_t size = 0;
+    for (int shift = 0; ; shift += 7) {
+        const int byte = _file.get();
+        if (byte == std::char_traits<char>::eof()) {
+            return false;
+        }
+
+        if (shift >= 64) {
+            throw std::runtime_error("Journal contains a malformed record length");
+        }
+
+        size |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+
+    if (size > max_record_size) {
+        throw std::runtime_error("Journal contains a record of " + std::to_string(size) + " bytes");
+    }
+
+    _payload.resize(size);
+    _file.read(&_payload[0], size);
+    if (static_cast<uint64_t>(_file.gcount()) != size) {
+        return false;
+    }
+
+    payload_reader reader(_payload);
+    const uint8_t type = reader.byte();
+    if (type > static_cast<uint8_t>(event_type::complete_item)) {
+        throw std::runtime_error("Journal contains an unknown event type " + std::to_string(type));
+    }
+    e.type = static_cast<event_type>(type);
+    e.item = reader.varint();
+    e.parent = reader.varint();
+    e.time = reader.time();
+    reader.string(e.name);
+    reader.string(e.description);
+    e.item_type = static_cast<report_portal::test_item_type>(reader.byte());
+    e.status = static_cast<report_portal::test_item_status>(reader.byte());
+
+    // Each entry takes up at least four bytes of the record.
+    const uint64_t log_count = reader.varint();
+    if (log_count > reader.remaining() / 4) {
+        throw std::runtime_error("Journal contains a truncated log");
+    }
+    e.logs.resize(log_count);
+    for (log_entry& entry : e.logs) {
+        entry.item = reader.varint();
+        entry.time = reader.time();
+        entry.level = static_cast<report_portal::log_level>(reader.byte());
+        reader.string(entry.message);
+    }
+
+    e.rerun_of = uuids::uuid();
+    if (_version >= 2) {
+        reader.string(_uuid);
+        if (!_uuid.empty()) {
+            e.rerun_of = uuids::uuid::from_string(_uuid);
+        }
+    }
+
+    e.end_time = std::chrono::system_clock::time_point();
+    if (_version >= 3) {
+        e.end_time = reader.time();
+    }
+
+    return true;
+}
+
+std::string unused_path(const std::string& path)
+{
+    std::string candidate = path;
+    for (int suffix = 1; std::ifstream(candidate).good(); ++suffix) {
+        candidate = path + "." + std::to_string(suffix);
+    }
+    return candidate;
+}
+
+uint64_t replay_journal(const std::string& path, ireporter& target)
+{
+    journal_reader reader(path);
+
+    uint64_t count = 0;
+    event e;
+    while (reader.next(e)) {
+        target.report(e);
+        ++count;
+    }
+
+    target.flush();
+    return count;
+}
+
+}
+}
@@ -0,0 +1,43 @@
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+#include <reportportal/launch.hpp>
+#include <reportportal/service.hpp>
+
+// Starts and finishes the launch that the shards of a sharded test run report
+// into. Start it before the shards run and hand the printed uuid to each of
+// them in RP_LAUNCH_UUID, then finish it once they are all done.
+int main(int argc, char **argv)
+{
+    const bool start = argc == 7 && std::strcmp(argv[1], "start") == 0;
+    const bool finish = argc == 7 && std::strcmp(argv[1], "finish") == 0;
+    if (!start && !finish) {
+        std::cerr << "usage: " << argv[0] << " start <name> <url> <project> <user> <password>\n"
+                  << "       " << argv[0] << " finish <uuid> <url> <project> <user> <password>" << std::endl;
+        return 2;
+    }
+
+    try {
+        report_portal::service service(argv[3], argv[4], argv[5], argv[6]);
+        if (start) {
+            report_portal::launch launch(service, argv[2]);
+            launch.start(std::chrono::system_clock::now());
+            std::cout << uuids::to_string(launch.id()) << std::endl;
+        } else {
+            const uuids::uuid id = uuids::uuid::from_string(argv[2]);
+            if (id.is_nil()) {
+                std::cerr << "Invalid launch uuid " << argv[2] << std::endl;
+                return 2;
+            }
+
+            service.end_launch(id, std::chrono::system_clock::now());
+        }
+    } catch (const std::exception& error) {
+        std::cerr << "Launch " << argv[1] << " failed: " << error.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
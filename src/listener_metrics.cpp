@@ -0,0 +1,193 @@
+#include <reportportal/gtest/listener_metrics.hpp>
+
+#include <cmath>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+static std::size_t bucket_of(uint64_t nanoseconds)
+{
+    std::size_t bucket = 0;
+    while (nanoseconds != 0 && bucket + 1 < latency_histogram::bucket_count) {
+        nanoseconds >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void latency_histogram::record(std::chrono::nanoseconds latency) {
+    if (latency < std::chrono::nanoseconds::zero()) {
+        latency = std::chrono::nanoseconds::zero();
+    }
+
+    ++_buckets[bucket_of(static_cast<uint64_t>(latency.count()))];
+    ++_count;
+    _total += latency;
+    if (latency > _max) {
+        _max = latency;
+    }
+}
+
+uint64_t latency_histogram::count() const {
+    return _count;
+}
+
+std::chrono::nanoseconds latency_histogram::total() const {
+    return _total;
+}
+
+std::chrono::nanoseconds latency_histogram::max() const {
+    return _max;
+}
+
+std::chrono::nanoseconds latency_histogram::percentile(double fraction) const {
+    if (_count == 0) {
+        return std::chrono::nanoseconds::zero();
+    }
+
+    const uint64_t wanted = static_cast<uint64_t>(std::ceil(fraction * _count));
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        seen += _buckets[i];
+        if (seen >= wanted && seen > 0) {
+            // No latency in the bucket exceeds the largest one recorded.
+            const std::chrono::nanoseconds upper((uint64_t(1) << i) - 1);
+            return upper < _max ? upper : _max;
+        }
+    }
+
+    return _max;
+}
+
+const std::array<uint64_t, latency_histogram::bucket_count>& latency_histogram::buckets() const {
+    return _buckets;
+}
+
+const char* to_string(listener_hook hook)
+{
+    switch (hook) {
+        case listener_hook::test_program_start:
+            return "test_program_start";
+        case listener_hook::test_suite_start:
+            return "test_suite_start";
+        case listener_hook::test_start:
+            return "test_start";
+        case listener_hook::test_part_result:
+            return "test_part_result";
+        case listener_hook::test_end:
+            return "test_end";
+        case listener_hook::log:
+            return "log";
+        case listener_hook::test_suite_end:
+            return "test_suite_end";
+        case listener_hook::test_program_end:
+            return "test_program_end";
+    }
+
+    return "unknown";
+}
+
+latency_histogram& listener_metrics::hook(listener_hook h) {
+    return hooks[static_cast<std::size_t>(h)];
+}
+
+const latency_histogram& listener_metrics::hook(listener_hook h) const {
+    return hooks[static_cast<std::size_t>(h)];
+}
+
+void listener_metrics::write_json(std::ostream& out) const {
+    out << "{\"hooks\":{";
+    for (std::size_t i = 0; i < listener_hook_count; ++i) {
+        const latency_histogram& histogram = hooks[i];
+        out << (i ? "," : "") << '"' << to_string(static_cast<listener_hook>(i)) << "\":{"
+            << "\"count\":" << histogram.count()
+            << ",\"total_ns\":" << histogram.total().count()
+            << ",\"max_ns\":" << histogram.max().count()
+            << ",\"p50_ns\":" << histogram.percentile(0.5).count()
+            << ",\"p99_ns\":" << histogram.percentile(0.99).count()
+            << ",\"buckets\":[";
+
+        // Trailing empty buckets are left out.
+        std::size_t used = histogram.buckets().size();
+        while (used > 0 && histogram.buckets()[used - 1] == 0) {
+            --used;
+        }
+        for (std::size_t j = 0; j < used; ++j) {
+            out << (j ? "," : "") << histogram.buckets()[j];
+        }
+        out << "]}";
+    }
+    out << "}"
+        << ",\"events\":" << events
+        << ",\"log_entries\":" << log_entries
+        << ",\"bytes_reported\":" << bytes_reported
+        << ",\"unflushed_events\":" << unflushed_events
+        << ",\"dropped_test_logs\":" << dropped_test_logs
+        << ",\"queued\":" << reporter.queued
+        << ",\"max_queued\":" << reporter.max_queued
+        << ",\"blocked\":" << reporter.blocked
+        << ",\"spilled\":" << reporter.spilled
+        << ",\"dropped_logs\":" << reporter.dropped_logs
+        << ",\"requests\":" << reporter.requests
+        << ",\"failed_requests\":" << reporter.failed_requests
+        << ",\"retries\":" << reporter.retries
+        << ",\"abandoned_events\":" << reporter.abandoned_events
+        << ",\"fallback_events\":" << reporter.fallback_events
+        << ",\"bytes_written\":" << reporter.bytes_written
+        << "}";
+}
+
+void listener_metrics::write_text(std::ostream& out) const {
+    std::chrono::nanoseconds overhead = std::chrono::nanoseconds::zero();
+    for (std::size_t i = 0; i < listener_hook_count; ++i) {
+        // log is already part of test_part_result.
+        if (static_cast<listener_hook>(i) != listener_hook::log) {
+            overhead += hooks[i].total();
+        }
+    }
+
+    out << "ReportPortal agent overhead: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(overhead).count() << " us\n";
+    for (std::size_t i = 0; i < listener_hook_count; ++i) {
+        const latency_histogram& histogram = hooks[i];
+        if (histogram.count() == 0) {
+            continue;
+        }
+
+        out << "  " << to_string(static_cast<listener_hook>(i))
+            << ": count " << histogram.count()
+            << ", p50 " << histogram.percentile(0.5).count() << " ns"
+            << ", p99 " << histogram.percentile(0.99).count() << " ns"
+            << ", max " << histogram.max().count() << " ns\n";
+    }
+    out << "  events " << events
+        << ", log entries " << log_entries
+        << ", bytes " << bytes_reported << "\n"
+        << "  queued " << reporter.queued
+        << " (max " << reporter.max_queued
+        << ", blocked " << reporter.blocked
+        << ", spilled " << reporter.spilled
+        << ", dropped logs " << reporter.dropped_logs << ")"
+        << ", requests " << reporter.requests
+        << " (failed " << reporter.failed_requests
+        << ", retried " << reporter.retries << ")";
+    if (reporter.abandoned_events > 0 || reporter.fallback_events > 0) {
+        out << ", abandoned events " << reporter.abandoned_events
+            << ", fallback events " << reporter.fallback_events;
+    }
+    if (reporter.bytes_written > 0) {
+        out << ", journal bytes " << reporter.bytes_written;
+    }
+    if (unflushed_events > 0) {
+        out << ", unflushed events " << unflushed_events;
+    }
+    if (dropped_test_logs > 0) {
+        out << ", dropped test logs " << dropped_test_logs;
+    }
+    out << "\n";
+}
+
+}
+}
@@ -0,0 +1,45 @@
+#include <reportportal/gtest/listener_options.hpp>
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+static int parse_int(const char* name, const char* value)
+{
+    int result = 0;
+    const char* end = value + std::strlen(value);
+    const std::from_chars_result parsed = std::from_chars(value, end, result);
+    if (parsed.ec != std::errc() || parsed.ptr != end || result < 0) {
+        throw std::invalid_argument(std::string(name) + " is not a valid count: " + value);
+    }
+
+    return result;
+}
+
+void apply_environment(listener_options& options)
+{
+    if (const char* uuid = std::getenv("RP_LAUNCH_UUID")) {
+        options.launch_uuid = uuid;
+    }
+
+    if (const char* finish = std::getenv("RP_FINISH_LAUNCH")) {
+        options.finish_launch = parse_int("RP_FINISH_LAUNCH", finish) != 0;
+    }
+
+    if (const char* index = std::getenv("GTEST_SHARD_INDEX")) {
+        options.shard_index = parse_int("GTEST_SHARD_INDEX", index);
+    }
+
+    if (const char* total = std::getenv("GTEST_TOTAL_SHARDS")) {
+        options.total_shards = parse_int("GTEST_TOTAL_SHARDS", total);
+    }
+}
+
+}
+}
@@ -0,0 +1,169 @@
+#include <reportportal/gtest/log_batcher.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+log_batcher::log_batcher(
+    std::unique_ptr<ireporter> target,
+    std::size_t max_entries,
+    std::size_t max_bytes,
+    std::chrono::milliseconds max_delay)
+  : _target(std::move(target)),
+    _max_entries(max_entries),
+    _max_bytes(max_bytes),
+    _max_delay(max_delay)
+{
+    if (!_target) {
+        throw std::invalid_argument("log_batcher needs a reporter to forward to");
+    }
+
+    _pending.type = event_type::log;
+    _batch.type = event_type::log;
+
+    // Without a delay every batch goes out with the event that filled it.
+    if (_max_delay.count() > 0) {
+        _timer = std::thread(&log_batcher::run_timer, this);
+    }
+}
+
+log_batcher::~log_batcher() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _changed.notify_one();
+    if (_timer.joinable()) {
+        _timer.join();
+    }
+}
+
+void log_batcher::report(const event& e) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (e.type != event_type::log) {
+        // Logs have to reach an item before it ends.
+        const bool item_ending = e.type == event_type::end_item && is_pending(e.item);
+        const bool launch_ending = e.type == event_type::end_launch || e.type == event_type::leave_launch;
+        if (item_ending || launch_ending) {
+            send_pending(*_target);
+        }
+
+        _target->report(e);
+    } else {
+        if (_pending.logs.empty()) {
+            _oldest = std::chrono::steady_clock::now();
+            _changed.notify_one();
+        }
+
+        for (const log_entry& entry : e.logs) {
+            _pending.logs.push_back(entry);
+            _pending_bytes += entry.message.size();
+        }
+    }
+
+    const bool full = _pending.logs.size() >= _max_entries || _pending_bytes >= _max_bytes;
+    if (!_pending.logs.empty() && (full || std::chrono::steady_clock::now() - _oldest >= _max_delay)) {
+        send_pending(*_target);
+    }
+}
+
+void log_batcher::flush() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        send_pending(*_target);
+    }
+    rethrow_error();
+    _target->flush();
+}
+
+bool log_batcher::flush_until(std::chrono::steady_clock::time_point deadline) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        send_pending(*_target);
+    }
+    rethrow_error();
+    return _target->flush_until(deadline);
+}
+
+uint64_t log_batcher::abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint64_t handed_over = _target->abandon(overflow, deadline);
+    if (!_pending.logs.empty()) {
+        send_pending(overflow);
+        ++handed_over;
+    }
+    return handed_over;
+}
+
+std::size_t log_batcher::pending() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending.logs.size();
+}
+
+void log_batcher::collect(reporter_metrics& metrics) const {
+    _target->collect(metrics);
+}
+
+bool log_batcher::is_pending(item_handle item) const {
+    return std::any_of(_pending.logs.begin(), _pending.logs.end(), [item](const log_entry& entry) {
+        return entry.item == item;
+    });
+}
+
+void log_batcher::send_pending(ireporter& to) {
+    if (_pending.logs.empty()) {
+        return;
+    }
+
+    // Swapping keeps the storage of both for the next batch.
+    _batch.logs.swap(_pending.logs);
+    _pending.logs.clear();
+    _pending_bytes = 0;
+
+    to.report(_batch);
+}
+
+void log_batcher::rethrow_error() {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(error, _error);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Sends the batch once its oldest entry has waited max_delay, for when no
+// report comes along to do it.
+void log_batcher::run_timer() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopping) {
+        if (_pending.logs.empty()) {
+            _changed.wait(lock);
+            continue;
+        }
+
+        const std::chrono::steady_clock::time_point due = _oldest + _max_delay;
+        if (std::chrono::steady_clock::now() < due) {
+            _changed.wait_until(lock, due);
+            continue;
+        }
+
+        try {
+            send_pending(*_target);
+        } catch (...) {
+            if (!_error) {
+                _error = std::current_exception();
+            }
+        }
+    }
+}
+
+}
+}
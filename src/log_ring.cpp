@@ -0,0 +1,130 @@
+#include <reportportal/gtest/log_ring.hpp>
+
+#include <stdexcept>
+#include <thread>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// A slot is free for the push at position p when its sequence is p, and holds
+// the entry pushed at p once its sequence is p + 1. Popping it hands it on to
+// the push at p + capacity. Slots take up a cache line each so producers
+// writing neighbouring slots do not slow each other down.
+struct alignas(64) log_ring::slot
+{
+    std::atomic<std::size_t> sequence{0};
+    report_portal::log_level level = report_portal::log_level::info;
+    std::chrono::system_clock::time_point time;
+    std::string message;
+};
+
+static std::size_t round_up_to_power_of_two(std::size_t value)
+{
+    std::size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+// log counts itself in before it loads the installed ring and out once it is
+// done with it, so once a ring has been swapped out it is no longer in use as
+// soon as the count drops to zero. Both are sequentially consistent to keep
+// the load from moving ahead of the count.
+static std::atomic<log_ring*> installed_ring{nullptr};
+static std::atomic<std::size_t> logging_threads{0};
+
+log_ring::log_ring(std::size_t capacity)
+  : _slots(new slot[round_up_to_power_of_two(capacity)]),
+    _mask(round_up_to_power_of_two(capacity) - 1)
+{
+    if (capacity == 0) {
+        throw std::invalid_argument("log_ring needs a capacity of at least one");
+    }
+
+    for (std::size_t i = 0; i <= _mask; ++i) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+log_ring::~log_ring() {
+    uninstall();
+}
+
+bool log_ring::push(report_portal::log_level level, std::string_view message) {
+    std::size_t position = _tail.load(std::memory_order_relaxed);
+    slot* claimed = nullptr;
+    while (!claimed) {
+        slot& candidate = _slots[position & _mask];
+        const std::size_t sequence = candidate.sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+            if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                claimed = &candidate;
+            }
+        } else if (sequence < position) {
+            // The slot still holds the entry from one lap ago.
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = _tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    claimed->level = level;
+    claimed->time = std::chrono::system_clock::now();
+    claimed->message.assign(message.data(), message.size());
+    claimed->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+bool log_ring::pop(log_entry& entry) {
+    slot& next = _slots[_head & _mask];
+    if (next.sequence.load(std::memory_order_acquire) != _head + 1) {
+        return false;
+    }
+
+    entry.level = next.level;
+    entry.time = next.time;
+    entry.message.swap(next.message);
+
+    next.sequence.store(_head + _mask + 1, std::memory_order_release);
+    ++_head;
+    return true;
+}
+
+std::size_t log_ring::capacity() const {
+    return _mask + 1;
+}
+
+uint64_t log_ring::dropped() const {
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+void log_ring::uninstall() {
+    log_ring* self = this;
+    installed_ring.compare_exchange_strong(self, nullptr);
+    while (logging_threads.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+bool log(report_portal::log_level level, std::string_view message)
+{
+    logging_threads.fetch_add(1);
+    log_ring* ring = installed_ring.load();
+
+    const bool pushed = ring && ring->push(level, message);
+
+    logging_threads.fetch_sub(1);
+    return pushed;
+}
+
+void set_log_ring(log_ring* ring)
+{
+    installed_ring.store(ring, std::memory_order_release);
+}
+
+}
+}
@@ -0,0 +1,287 @@
+#include <reportportal/gtest/output_capture.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace reportportal
+{
+namespace gtest
+{
+
+#ifdef _WIN32
+
+output_capture::output_capture(std::size_t head_bytes, std::size_t tail_bytes)
+  : _head_bytes(head_bytes),
+    _tail_bytes(tail_bytes)
+{
+    throw std::runtime_error("Capturing the output of tests is not supported on this platform");
+}
+
+output_capture::~output_capture() {}
+
+void output_capture::restart() {}
+
+uint64_t output_capture::take(std::string& text) {
+    return 0;
+}
+
+#else
+
+// Writes all of data to fd, which may take several writes.
+static void write_fully(int fd, const char* data, std::size_t size)
+{
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // The console is gone; the output is still kept.
+            return;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+static void close_on_exec(int fd)
+{
+    ::fcntl(fd, F_SETFD, ::fcntl(fd, F_GETFD) | FD_CLOEXEC);
+}
+
+// Bytes waiting in a pipe.
+static int pending(int fd)
+{
+    int bytes = 0;
+    return ::ioctl(fd, FIONREAD, &bytes) == 0 ? bytes : 0;
+}
+
+static void flush_streams()
+{
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(stdout);
+    std::fflush(stderr);
+}
+
+output_capture::output_capture(std::size_t head_bytes, std::size_t tail_bytes)
+  : _head_bytes(head_bytes),
+    _tail_bytes(tail_bytes),
+    _tail(tail_bytes, '\0')
+{
+    _head.reserve(head_bytes);
+
+    if (::pipe(_wake.data()) != 0) {
+        throw std::runtime_error("Unable to create a pipe to capture output");
+    }
+    close_on_exec(_wake[0]);
+    close_on_exec(_wake[1]);
+
+    flush_streams();
+    for (std::size_t i = 0; i < _fds.size(); ++i) {
+        int ends[2];
+        if (::pipe(ends) != 0) {
+            restore(i);
+            throw std::runtime_error("Unable to create a pipe to capture output");
+        }
+        close_on_exec(ends[0]);
+        _pipes[i] = ends[0];
+
+        _originals[i] = ::dup(_fds[i]);
+        if (_originals[i] < 0 || ::dup2(ends[1], _fds[i]) < 0) {
+            ::close(ends[1]);
+            restore(i + 1);
+            throw std::runtime_error("Unable to redirect output to a pipe");
+        }
+        close_on_exec(_originals[i]);
+        ::close(ends[1]);
+    }
+
+    _thread = std::thread(&output_capture::run, this);
+}
+
+output_capture::~output_capture() {
+    flush_streams();
+    for (std::size_t i = 0; i < _fds.size(); ++i) {
+        ::dup2(_originals[i], _fds[i]);
+    }
+
+    const char wake = 0;
+    write_fully(_wake[1], &wake, 1);
+    _thread.join();
+
+    restore(_fds.size());
+}
+
+// Puts the first streams back, if they were redirected, and closes what was
+// opened for them and the wake pipe.
+void output_capture::restore(std::size_t streams) {
+    for (std::size_t i = 0; i < streams; ++i) {
+        if (_originals[i] >= 0) {
+            ::dup2(_originals[i], _fds[i]);
+            ::close(_originals[i]);
+            _originals[i] = -1;
+        }
+        if (_pipes[i] >= 0) {
+            ::close(_pipes[i]);
+            _pipes[i] = -1;
+        }
+    }
+    ::close(_wake[0]);
+    ::close(_wake[1]);
+}
+
+void output_capture::restart() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    wait_until_read(lock);
+
+    _head.clear();
+    _tail_begin = 0;
+    _tail_size = 0;
+    _total = 0;
+}
+
+uint64_t output_capture::take(std::string& text) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    wait_until_read(lock);
+
+    text.assign(_head);
+    const uint64_t skipped = _total - _head.size() - _tail_size;
+    if (skipped > 0) {
+        text += "\n[... ";
+        text += std::to_string(skipped);
+        text += " bytes skipped ...]\n";
+    }
+
+    const std::size_t first = std::min(_tail_size, _tail_bytes - _tail_begin);
+    text.append(_tail, _tail_begin, first);
+    text.append(_tail, 0, _tail_size - first);
+    return _total;
+}
+
+// Waits only for the bytes in the pipes, or being read, at the time of the
+// call, so a thread that keeps writing does not hold the caller up, and for
+// no longer than a second in case the console blocks the background thread.
+void output_capture::wait_until_read(std::unique_lock<std::mutex>& lock) {
+    lock.unlock();
+    flush_streams();
+    lock.lock();
+
+    const uint64_t consumed = _consumed + pending(_pipes[0]) + pending(_pipes[1]);
+    const uint64_t reads = _reads + (_reading ? 1 : 0);
+    _read.wait_for(lock, std::chrono::seconds(1), [this, consumed, reads] {
+        return _consumed >= consumed && _reads >= reads;
+    });
+}
+
+void output_capture::run() {
+    pollfd fds[3] = {
+        {_pipes[0], POLLIN, 0},
+        {_pipes[1], POLLIN, 0},
+        {_wake[0], POLLIN, 0}
+    };
+
+    while (true) {
+        if (::poll(fds, 3, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        for (std::size_t i = 0; i < _fds.size(); ++i) {
+            if (fds[i].revents & (POLLIN | POLLHUP)) {
+                read_from(i);
+            }
+        }
+
+        if (fds[2].revents & POLLIN) {
+            // Pass on whatever was written before stdout and stderr were put
+            // back.
+            for (std::size_t i = 0; i < _fds.size(); ++i) {
+                while (pending(_pipes[i]) > 0) {
+                    read_from(i);
+                }
+            }
+            return;
+        }
+    }
+}
+
+// _reading covers the time between taking bytes out of the pipe and keeping
+// them, when neither the pipe nor the capture shows them.
+void output_capture::read_from(std::size_t stream) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _reading = true;
+    }
+
+    const ssize_t size = ::read(_pipes[stream], _buffer.data(), _buffer.size());
+    if (size > 0) {
+        write_fully(_originals[stream], _buffer.data(), static_cast<std::size_t>(size));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (size > 0) {
+            keep(_buffer.data(), static_cast<std::size_t>(size));
+            _consumed += static_cast<std::size_t>(size);
+        }
+        _reading = false;
+        ++_reads;
+    }
+    _read.notify_all();
+}
+
+// Fills the head first and then the tail, a ring overwriting its oldest bytes.
+// Expects _mutex to be held.
+void output_capture::keep(const char* data, std::size_t size) {
+    _total += size;
+
+    const std::size_t to_head = std::min(size, _head_bytes - _head.size());
+    _head.append(data, to_head);
+    data += to_head;
+    size -= to_head;
+
+    if (_tail_bytes == 0 || size == 0) {
+        return;
+    }
+
+    if (size >= _tail_bytes) {
+        data += size - _tail_bytes;
+        size = _tail_bytes;
+        _tail_begin = 0;
+        _tail_size = 0;
+    }
+
+    while (size > 0) {
+        const std::size_t end = (_tail_begin + _tail_size) % _tail_bytes;
+        const std::size_t chunk = std::min(size, _tail_bytes - end);
+        std::memcpy(&_tail[end], data, chunk);
+        data += chunk;
+        size -= chunk;
+
+        _tail_size += chunk;
+        if (_tail_size > _tail_bytes) {
+            _tail_begin = (_tail_begin + _tail_size - _tail_bytes) % _tail_bytes;
+            _tail_size = _tail_bytes;
+        }
+    }
+}
+
+#endif
+
+}
+}
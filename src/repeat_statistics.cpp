@@ -0,0 +1,112 @@
+#include <reportportal/gtest/repeat_statistics.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+void repeat_statistics::record(report_portal::test_item_status status, std::chrono::milliseconds duration) {
+    switch (status) {
+        case report_portal::test_item_status::passed:
+            ++_passed;
+            break;
+        case report_portal::test_item_status::failed:
+            ++_failed;
+            break;
+        default:
+            ++_skipped;
+            return;
+    }
+
+    _durations.push_back(duration);
+    _total += duration;
+}
+
+uint64_t repeat_statistics::runs() const {
+    return _passed + _failed + _skipped;
+}
+
+uint64_t repeat_statistics::passed() const {
+    return _passed;
+}
+
+uint64_t repeat_statistics::failed() const {
+    return _failed;
+}
+
+uint64_t repeat_statistics::skipped() const {
+    return _skipped;
+}
+
+std::chrono::milliseconds repeat_statistics::min() const {
+    if (_durations.empty()) {
+        return std::chrono::milliseconds::zero();
+    }
+
+    return *std::min_element(_durations.begin(), _durations.end());
+}
+
+std::chrono::milliseconds repeat_statistics::mean() const {
+    if (_durations.empty()) {
+        return std::chrono::milliseconds::zero();
+    }
+
+    return _total / _durations.size();
+}
+
+std::chrono::milliseconds repeat_statistics::max() const {
+    if (_durations.empty()) {
+        return std::chrono::milliseconds::zero();
+    }
+
+    return *std::max_element(_durations.begin(), _durations.end());
+}
+
+// The nearest rank: the smallest duration that at least fraction of the
+// iterations took no longer than.
+std::chrono::milliseconds repeat_statistics::percentile(double fraction) const {
+    if (_durations.empty()) {
+        return std::chrono::milliseconds::zero();
+    }
+
+    const double rank = std::ceil(std::clamp(fraction, 0.0, 1.0) * _durations.size());
+    const std::size_t index = rank < 1.0 ? 0 : static_cast<std::size_t>(rank) - 1;
+
+    std::vector<std::chrono::milliseconds> sorted = _durations;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+report_portal::test_item_status repeat_statistics::status() const {
+    if (_failed > 0) {
+        return report_portal::test_item_status::failed;
+    }
+
+    return _passed > 0 ? report_portal::test_item_status::passed : report_portal::test_item_status::skipped;
+}
+
+void repeat_statistics::describe(std::string& out) const {
+    out += "Ran ";
+    out += std::to_string(runs());
+    out += " times: ";
+    out += std::to_string(_passed);
+    out += " passed, ";
+    out += std::to_string(_failed);
+    out += " failed, ";
+    out += std::to_string(_skipped);
+    out += " skipped\nduration min ";
+    out += std::to_string(min().count());
+    out += " ms, mean ";
+    out += std::to_string(mean().count());
+    out += " ms, p99 ";
+    out += std::to_string(percentile(0.99).count());
+    out += " ms, max ";
+    out += std::to_string(max().count());
+    out += " ms";
+}
+
+}
+}
@@ -0,0 +1,29 @@
+#include <exception>
+#include <iostream>
+
+#include <reportportal/service.hpp>
+
+#include <reportportal/gtest/journal.hpp>
+#include <reportportal/gtest/service_reporter.hpp>
+
+// Uploads a journal written by the event_listener in spool mode.
+int main(int argc, char **argv)
+{
+    if (argc != 6) {
+        std::cerr << "usage: " << argv[0] << " <journal> <url> <project> <user> <password>" << std::endl;
+        return 2;
+    }
+
+    try {
+        report_portal::service service(argv[2], argv[3], argv[4], argv[5]);
+        reportportal::gtest::service_reporter reporter(service);
+
+        const uint64_t count = reportportal::gtest::replay_journal(argv[1], reporter);
+        std::cout << "Replayed " << count << " events from " << argv[1] << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << "Replaying " << argv[1] << " failed: " << error.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <reportportal/gtest/ireporter.hpp>
+#include <reportportal/gtest/journal.hpp>
+#include <reportportal/gtest/listener_options.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Hands events to a background thread which reports them to the wrapped
+// reporter, so the test thread never waits on the ReportPortal server unless
+// the queue is full.
+//
+// The queue is a fixed ring of event slots that are assigned into rather than
+// reallocated, so once every slot has been used reporting an event does not
+// allocate any more than copying its strings requires.
+//
+// With a memory budget the queue also counts as full once its events take up
+// that many bytes, and slots that held an event larger than their share of the
+// budget give their memory back, so a slow server can not make the queue grow
+// past the budget. What happens to events that do not fit is up to the
+// overflow policy; spilled events are written to a journal at spill_path, or
+// at a fresh name next to it if a file is already there, and delivered after
+// everything queued before them.
+class async_reporter : public ireporter
+{
+    public:
+        async_reporter(
+            std::unique_ptr<ireporter> target,
+            std::size_t capacity,
+            std::size_t memory_budget = 0,
+            overflow_policy overflow = overflow_policy::block,
+            const std::string& spill_path = std::string());
+
+        // Delivers everything still queued before returning.
+        ~async_reporter() override;
+
+        async_reporter(const async_reporter&) = delete;
+        async_reporter& operator=(const async_reporter&) = delete;
+
+        // Queues the event. When the queue is full this blocks, spills the
+        // event or drops it, depending on the overflow policy.
+        void report(const event& e) override;
+
+        // Waits until the background thread has delivered everything queued so
+        // far. Rethrows the first error the background thread ran into.
+        void flush() override;
+
+        bool flush_until(std::chrono::steady_clock::time_point deadline) override;
+
+        // Stops delivering, abandons the target and then has the background
+        // thread hand the remaining events to overflow rather than the target,
+        // so overflow receives events oldest first. When the event being
+        // delivered is still on its way at deadline, the remaining events are
+        // handed over from the calling thread instead, and the background
+        // thread goes on with new events once that one has been delivered.
+        // Until then the target is still in use, and the destructor waits for
+        // it, so an owner that can not wait has to leave this undestroyed.
+        uint64_t abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) override;
+
+        // Stops the background thread from delivering anything more until
+        // abandon is called. Waits for the event being delivered, if any, and
+        // returns false if it is still on its way at deadline.
+        bool pause(std::chrono::steady_clock::time_point deadline);
+
+        // Number of events waiting to be delivered, spilled ones included.
+        std::size_t pending() const;
+
+        void collect(reporter_metrics& metrics) const override;
+
+    private:
+        uint64_t hand_over_behind(ireporter& overflow);
+        bool fits(std::size_t bytes) const;
+        void enqueue(const event& e, std::size_t bytes);
+        void spill(const event& e);
+        void deliver(const event& e, ireporter* overflow);
+        void run();
+
+        std::unique_ptr<ireporter> _target;
+        const std::size_t _memory_budget;
+        const overflow_policy _overflow;
+        const std::string _spill_path;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _not_empty;
+        std::condition_variable _not_full;
+        std::condition_variable _drained;
+        std::condition_variable _idle;
+
+        std::vector<event> _slots;
+        std::vector<std::size_t> _slot_bytes;
+        std::size_t _head = 0;
+        std::size_t _size = 0;
+        std::size_t _max_size = 0;
+        std::size_t _queued_bytes = 0;
+        bool _stopping = false;
+        std::exception_ptr _error;
+
+        // Set while abandon waits for the queue to be handed over.
+        bool _paused = false;
+        bool _delivering = false;
+        bool _delivering_spilled = false;
+        ireporter* _overflow_target = nullptr;
+        uint64_t _handed_over = 0;
+
+        // Written to by the test thread and read by the background thread,
+        // both with _mutex held while _spill_pending changes.
+        std::string _spill_file;
+        std::unique_ptr<journal_writer> _spill_writer;
+        std::unique_ptr<journal_reader> _spill_reader;
+        std::size_t _spill_pending = 0;
+        event _unspilled;
+
+        uint64_t _blocked = 0;
+        uint64_t _spilled = 0;
+        uint64_t _dropped_logs = 0;
+
+        std::thread _thread;
+};
+
+}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <uuid.h>
+#include <reportportal/test_item.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Client side identifier for a launch or test item. Handles are assigned by the
+// listener when something is started so later events can refer to it before the
+// ReportPortal server has handed out the real uuid.
+using item_handle = uint64_t;
+
+// Handle that never refers to anything.
+constexpr item_handle null_handle = 0;
+
+enum class event_type
+{
+    begin_launch,
+    end_launch,
+    begin_item,
+    end_item,
+    log,
+    leave_launch,
+    complete_item
+};
+
+struct log_entry
+{
+    item_handle item = null_handle;
+    std::chrono::system_clock::time_point time;
+    report_portal::log_level level = report_portal::log_level::error;
+    std::string message;
+};
+
+// Everything the listener wants to tell ReportPortal. Which members are used
+// depends on the type:
+//   begin_launch: item, time, name, description, rerun_of
+//   end_launch:   item, time
+//   begin_item:   item, parent, time, name, description, item_type
+//   end_item:     item, time, status
+//   log:          logs
+//   leave_launch: item
+//   complete_item: item, parent, time, end_time, name, description,
+//                  item_type, status, logs
+//
+// leave_launch stops reporting into a launch without finishing it, for
+// processes that share a launch someone else finishes.
+//
+// complete_item stands for an item that has already ended: it begins at time,
+// gets logs and ends at end_time with status.
+struct event
+{
+    event_type type = event_type::begin_launch;
+    item_handle item = null_handle;
+    item_handle parent = null_handle;
+    std::chrono::system_clock::time_point time;
+    std::string name;
+    std::string description;
+    report_portal::test_item_type item_type = report_portal::test_item_type::suite;
+    report_portal::test_item_status status = report_portal::test_item_status::inherit;
+    std::vector<log_entry> logs;
+    std::chrono::system_clock::time_point end_time;
+
+    // Existing launch to report into instead of starting a new one. Nil when
+    // a new launch should be started.
+    uuids::uuid rerun_of;
+};
+
+}
+}
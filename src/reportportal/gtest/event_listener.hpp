@@ -1,10 +1,23 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <reportportal/service.hpp>
-#include <reportportal/launch.hpp>
-#include <reportportal/test_item.hpp>
+
+#include <reportportal/gtest/event.hpp>
+#include <reportportal/gtest/ireporter.hpp>
+#include <reportportal/gtest/listener_metrics.hpp>
+#include <reportportal/gtest/listener_options.hpp>
+#include <reportportal/gtest/log_ring.hpp>
+#include <reportportal/gtest/output_capture.hpp>
+#include <reportportal/gtest/repeat_statistics.hpp>
 
 namespace reportportal
 {
@@ -14,7 +27,30 @@ namespace gtest
 class event_listener : public ::testing::TestEventListener
 {
     public:
-        event_listener(report_portal::service& service);
+        // The service has to outlive the listener, so a flush deadline, past
+        // which a request may still be using it, is rejected.
+        event_listener(report_portal::iservice& service, const listener_options& options = listener_options());
+
+        // Keeps the service until the listener is destroyed, or, if a request
+        // was still using it at the flush deadline, for the rest of the
+        // program, so the test program does not wait for that request to end.
+        explicit event_listener(
+            std::unique_ptr<report_portal::iservice> service,
+            const listener_options& options = listener_options());
+
+        // Reports every event to the given reporter instead of building one from
+        // listener_options, so the options that shape the reporter, from
+        // asynchronous and the queue to retry, concurrent_requests,
+        // sender_threads, batch_logs and spool_path, are ignored. The rest apply as usual: the launch,
+        // sharding, metrics and flush options, defer_tests, aggregate_repeats
+        // and summarize_passes, log_message_limit, output capture and
+        // test_log_capacity.
+        explicit event_listener(std::unique_ptr<ireporter> reporter, const listener_options& options = listener_options());
+
+        // Waits for threads still logging to the listener. Leaves the reporter
+        // and the service undestroyed if a request was given up on at the
+        // flush deadline.
+        ~event_listener() override;
 
         // Fired before any test activity starts.
         void OnTestProgramStart(const ::testing::UnitTest& unit_test) override;
@@ -59,10 +95,116 @@ class event_listener : public ::testing::TestEventListener
         // Fired after all test activities have ended.
         void OnTestProgramEnd(const ::testing::UnitTest& unit_test) override;
 
+        // Time spent in the listener's hooks so far, along with what the
+        // reporters have done. Must be called from the thread running the
+        // tests.
+        listener_metrics metrics() const;
+
     private:
-        report_portal::service& _service;
-        std::unique_ptr<report_portal::launch> _launch;
-        std::vector<std::unique_ptr<report_portal::test_item> > _test_item_stack;
+        // An item that has begun but not ended yet. Its end is never reported
+        // before the end of any of its children.
+        struct running_item
+        {
+            item_handle item;
+            std::chrono::system_clock::time_point begin;
+            std::chrono::system_clock::time_point children_end;
+        };
+
+        // A suite or test reported once for all iterations in
+        // aggregate_repeats mode. It ends with the test program.
+        struct aggregated_item
+        {
+            item_handle item;
+            bool test;
+            std::chrono::system_clock::time_point end;
+            repeat_statistics statistics;
+        };
+
+        void report(const event& e);
+        void flush();
+        void abandon(std::chrono::steady_clock::time_point deadline);
+        void export_metrics() const;
+
+        event& reset_event(event_type type);
+        void begin_item(report_portal::test_item_type type);
+        void end_item(
+            std::chrono::system_clock::time_point end,
+            report_portal::test_item_status status = report_portal::test_item_status::inherit);
+        void begin_test(const ::testing::TestInfo& test_info);
+        void complete_item(std::chrono::system_clock::time_point end, report_portal::test_item_status status);
+        void pop_item(std::chrono::system_clock::time_point end);
+        std::chrono::system_clock::time_point end_after(std::chrono::milliseconds elapsed) const;
+        bool logs_deferred() const;
+        log_entry& begin_log_entry();
+        void end_log_entry();
+        void drain_test_logs();
+        void log_output();
+        bool resume_item(const void* key);
+        void aggregate_item(const void* key, bool test);
+        void leave_item(
+            const void* key,
+            std::chrono::system_clock::time_point end,
+            report_portal::test_item_status status,
+            std::chrono::milliseconds elapsed);
+        void end_aggregated_items();
+        void summarize_pass(const ::testing::TestInfo& test_info, std::chrono::milliseconds elapsed);
+        void log_passed_tests();
+
+        // Declared before the reporter, which uses it.
+        std::unique_ptr<report_portal::iservice> _service;
+        std::unique_ptr<ireporter> _reporter;
+        bool _gave_up = false;
+        uuids::uuid _launch_uuid;
+        bool _finish_launch = true;
+        std::string _root_name;
+        std::string _metrics_path;
+        bool _print_metrics = false;
+        std::chrono::milliseconds _flush_deadline;
+        std::string _flush_spool_path;
+        bool _defer_tests = false;
+        bool _aggregate_repeats = false;
+        bool _summarize_passes = false;
+        int _iteration = 0;
+        std::size_t _log_message_limit = 0;
+        bool _capture_output = false;
+        std::size_t _capture_head_bytes = 0;
+        std::size_t _capture_tail_bytes = 0;
+        item_handle _next_handle = null_handle;
+        item_handle _launch_handle = null_handle;
+        std::vector<running_item> _test_item_stack;
+
+        event _event;
+        event _log_event;
+
+        // The running test in defer_tests mode, reported once it ends. In
+        // aggregate_repeats mode only its logs are, if the iteration failed.
+        event _deferred;
+
+        // Items in aggregate_repeats mode in the order they began, looked up
+        // by the gtest TestSuite or TestInfo, which gtest keeps across
+        // iterations.
+        std::vector<aggregated_item> _aggregated;
+        std::unordered_map<const void*, std::size_t> _aggregated_index;
+
+        // Tests of the running suite that passed in summarize_passes mode,
+        // a line each with the test's name and duration.
+        std::string _passed_tests;
+        uint64_t _passed_count = 0;
+        std::chrono::milliseconds _passed_duration = std::chrono::milliseconds::zero();
+
+        listener_metrics _metrics;
+
+        // What tests logged with reportportal::gtest::log, drained into the
+        // running item by the hooks.
+        log_ring _test_logs;
+
+        // Output of the running test while the program runs, when captured.
+        std::unique_ptr<output_capture> _output;
+        std::string _output_text;
+
+        // Held by the hooks that report, since OnTestPartResult may be called
+        // from a test's own threads while another hook runs.
+        std::mutex _mutex;
 };
 
 }
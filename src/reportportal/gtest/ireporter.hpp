@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include <reportportal/gtest/event.hpp>
+#include <reportportal/gtest/listener_metrics.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Receives the events produced by the event_listener. Implementations either
+// deliver them to ReportPortal or decorate another reporter.
+class ireporter
+{
+    public:
+        virtual ~ireporter() = default;
+
+        // Events are reported in the order the listener produced them. Parents
+        // are always begun before their children and an item is never used
+        // after it has ended.
+        virtual void report(const event& e) = 0;
+
+        // Blocks until everything reported so far has been delivered.
+        virtual void flush() = 0;
+
+        // Like flush, but returns false instead of waiting past deadline.
+        // Reporters that never wait on anything flush as usual.
+        virtual bool flush_until(std::chrono::steady_clock::time_point deadline) {
+            flush();
+            return true;
+        }
+
+        // Hands every event still waiting to be delivered to overflow instead,
+        // oldest first, and returns how many there were. An event already on
+        // its way to the server is let through first, unless it is still on
+        // its way at deadline, in which case it is given up on: it is neither
+        // waited for nor handed over. Reporters talking to the server report
+        // the begin events of what is running there before anything else, so
+        // overflow can be replayed on its own.
+        virtual uint64_t abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) {
+            return 0;
+        }
+
+        // Adds this reporter's share to the metrics, and that of the
+        // reporters it forwards to. May be called from any thread.
+        virtual void collect(reporter_metrics& metrics) const {}
+};
+
+}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include <reportportal/gtest/ireporter.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Appends every event to a local journal file instead of sending it anywhere,
+// so a test run does not depend on the ReportPortal server at all. The journal
+// can be uploaded later with replay_journal.
+//
+// The journal starts with a small header followed by one record per event.
+// Each record is its length as a varint followed by the event with integers
+// encoded as varints and strings as a varint length followed by the bytes.
+// Records are only written whole, so a journal cut short by a crash can still
+// be replayed up to the last complete event. An existing journal is appended
+// to only when it has the version written here; anything else at path makes
+// the constructor throw.
+class journal_writer : public ireporter
+{
+    public:
+        explicit journal_writer(const std::string& path);
+
+        void report(const event& e) override;
+
+        // Pushes everything written so far out to the file.
+        void flush() override;
+
+        // Bytes appended to the journal by this writer.
+        uint64_t bytes_written() const;
+
+        void collect(reporter_metrics& metrics) const override;
+
+    private:
+        std::ofstream _file;
+        std::string _record;
+        std::string _payload;
+        std::atomic<uint64_t> _bytes_written{0};
+};
+
+// Reads back the events stored by a journal_writer.
+class journal_reader
+{
+    public:
+        explicit journal_reader(const std::string& path);
+
+        // Reads the next event into e. Returns false at the end of the journal
+        // or when the last record is incomplete, and throws when a record is
+        // implausibly long or malformed.
+        bool next(event& e);
+
+    private:
+        std::ifstream _file;
+        int _version = 0;
+        std::string _payload;
+        std::string _uuid;
+};
+
+// path, or the first of path.1, path.2 and so on that does not exist yet, for
+// a journal that must neither add to nor replace one already there.
+std::string unused_path(const std::string& path);
+
+// Reports every event stored in the journal at path to target, in the order
+// they were written, and flushes the target. Returns the number of events
+// replayed.
+uint64_t replay_journal(const std::string& path, ireporter& target);
+
+}
+}
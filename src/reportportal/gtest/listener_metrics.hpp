@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Distribution of latencies in power of two buckets of nanoseconds: bucket i
+// counts latencies below 2^i ns that did not fit into bucket i - 1. Recording
+// a latency is a handful of arithmetic instructions and never allocates.
+class latency_histogram
+{
+    public:
+        static constexpr std::size_t bucket_count = 64;
+
+        void record(std::chrono::nanoseconds latency);
+
+        uint64_t count() const;
+        std::chrono::nanoseconds total() const;
+        std::chrono::nanoseconds max() const;
+
+        // Upper bound of the bucket holding the given fraction of latencies,
+        // e.g. 0.99 for the 99th percentile. Zero when nothing was recorded.
+        std::chrono::nanoseconds percentile(double fraction) const;
+
+        const std::array<uint64_t, bucket_count>& buckets() const;
+
+    private:
+        std::array<uint64_t, bucket_count> _buckets = {};
+        uint64_t _count = 0;
+        std::chrono::nanoseconds _total = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds _max = std::chrono::nanoseconds::zero();
+};
+
+// Records the time from construction to destruction into a histogram.
+class scoped_latency
+{
+    public:
+        explicit scoped_latency(latency_histogram& histogram)
+          : _histogram(histogram),
+            _start(std::chrono::steady_clock::now())
+        {}
+
+        ~scoped_latency() {
+            _histogram.record(std::chrono::steady_clock::now() - _start);
+        }
+
+        scoped_latency(const scoped_latency&) = delete;
+        scoped_latency& operator=(const scoped_latency&) = delete;
+
+    private:
+        latency_histogram& _histogram;
+        const std::chrono::steady_clock::time_point _start;
+};
+
+// The parts of the listener whose latency is measured. log is the formatting
+// and reporting of failure logs within test_part_result.
+enum class listener_hook
+{
+    test_program_start,
+    test_suite_start,
+    test_start,
+    test_part_result,
+    test_end,
+    log,
+    test_suite_end,
+    test_program_end
+};
+
+constexpr std::size_t listener_hook_count = 8;
+
+const char* to_string(listener_hook hook);
+
+// What the reporters behind the listener add to the metrics. Each reporter
+// adds its own share in ireporter::collect, so counts of several queues or
+// services are summed.
+struct reporter_metrics
+{
+    // Events waiting in queues right now, and the most that ever waited in
+    // any one of them.
+    uint64_t queued = 0;
+    uint64_t max_queued = 0;
+
+    // What happened to events that did not fit into a queue: the times the
+    // test thread waited, events spilled to disk and log entries dropped.
+    uint64_t blocked = 0;
+    uint64_t spilled = 0;
+    uint64_t dropped_logs = 0;
+
+    // Requests made to the ReportPortal server and how many of them failed
+    // or were retried.
+    uint64_t requests = 0;
+    uint64_t failed_requests = 0;
+    uint64_t retries = 0;
+
+    // Events given up on after every attempt failed or once the server was
+    // taken to be down, and those written to the fallback journal instead.
+    uint64_t abandoned_events = 0;
+    uint64_t fallback_events = 0;
+
+    // Bytes appended to a journal in spool mode.
+    uint64_t bytes_written = 0;
+};
+
+// Overhead the event_listener added to a test program.
+struct listener_metrics
+{
+    std::array<latency_histogram, listener_hook_count> hooks;
+
+    // Events and log entries handed to the reporter, and the bytes of text
+    // they carried.
+    uint64_t events = 0;
+    uint64_t log_entries = 0;
+    uint64_t bytes_reported = 0;
+
+    // Events still waiting to be delivered at the flush deadline, which were
+    // written to the flush spool or dropped.
+    uint64_t unflushed_events = 0;
+
+    // Entries logged with reportportal::gtest::log that were dropped because
+    // the ring was full, i.e. more were logged between two hooks than
+    // test_log_capacity.
+    uint64_t dropped_test_logs = 0;
+
+    reporter_metrics reporter;
+
+    latency_histogram& hook(listener_hook h);
+    const latency_histogram& hook(listener_hook h) const;
+
+    // Writes the metrics as a single JSON object.
+    void write_json(std::ostream& out) const;
+
+    // Writes a short human readable summary.
+    void write_text(std::ostream& out) const;
+};
+
+}
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <string>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// What happens to an event that does not fit into the asynchronous queue.
+enum class overflow_policy
+{
+    // The test thread waits until there is room.
+    block,
+
+    // The event is appended to a file and read back once the queue has
+    // caught up.
+    spill,
+
+    // Log events are dropped, everything else waits, so the report still has
+    // every item and its status.
+    drop_logs
+};
+
+// How events the server failed to take are retried, and when to stop
+// trying. Nothing is retried with a single attempt.
+struct retry_policy
+{
+    // Tries per event, the first one included.
+    int attempts = 1;
+
+    // Before the n-th retry the reporter waits a random time of up to
+    // base_delay * 2^(n - 1), but never more than max_delay.
+    std::chrono::milliseconds base_delay = std::chrono::milliseconds(100);
+    std::chrono::milliseconds max_delay = std::chrono::seconds(5);
+
+    // Whether a failed attempt is worth another one. Errors that are not are
+    // rethrown straight away. When empty everything but a std::logic_error is
+    // retried: the client does not tell transport and server errors apart by
+    // type, while service_reporter throws logic errors for events that can
+    // never be delivered, such as one for an item it does not know.
+    std::function<bool(const std::exception& error)> retryable;
+
+    // Once this many events in a row have failed every attempt the server is
+    // taken to be down and nothing more is sent to it. A failed launch begin,
+    // or item begin when there is a fallback journal, does so on its own.
+    // Zero never gives up.
+    int breaker_threshold = 0;
+
+    // Journal that takes the rest of the run once the server is down, ready
+    // for reportportal-agent-googletest-replay. Those events are dropped when
+    // empty.
+    std::string fallback_path;
+};
+
+// Controls how the event_listener reports to ReportPortal.
+struct listener_options
+{
+    // Report from a background thread so tests do not wait on the server.
+    bool asynchronous = false;
+
+    // Number of events that may wait for the background thread before the
+    // test thread blocks. Only used when events are queued, i.e. when
+    // asynchronous is set or sender_threads is above one.
+    std::size_t queue_capacity = 4096;
+
+    // Bytes the queued events, their strings included, may take up before
+    // the queue counts as full, or zero for no limit beyond queue_capacity.
+    // The sender_threads share it equally, on top of the asynchronous queue's
+    // own. Only used when events are queued.
+    std::size_t queue_memory_budget = 0;
+
+    // What to do with events that do not fit into a queue. Spilled events
+    // go to overflow_path, or to overflow_path.1 and so on if it is taken,
+    // which is removed once it has been read back. Only used when events are
+    // queued.
+    overflow_policy overflow = overflow_policy::block;
+    std::string overflow_path;
+
+    // Longest the test program waits when it ends for the queue to be
+    // delivered, or zero to wait as long as it takes. While it waits the
+    // number of events left is printed to stderr every second. Events still
+    // queued at the deadline are written to flush_spool_path, or to
+    // flush_spool_path.1 and so on if it is taken, after the launch and the
+    // items they belong to, for reportportal-agent-googletest-replay to upload
+    // later; without a path they are dropped. Either way a summary is printed
+    // to stderr. A request still on its way at the deadline is not waited
+    // for, and goes on using the service after the listener is gone, so the
+    // listener has to be given the service to own. Only used when events are
+    // queued, i.e. when asynchronous is set or sender_threads is above one.
+    std::chrono::milliseconds flush_deadline = std::chrono::milliseconds(0);
+    std::string flush_spool_path;
+
+    // Report test suites to the server from this many threads in parallel.
+    // Each suite is reported by one thread, so the events of a suite stay in
+    // order and a run with a single large suite gains nothing. Each thread
+    // queues up to queue_capacity events, within its share of
+    // queue_memory_budget, and handles the rest by the overflow policy.
+    // Ignored in spool mode and below two.
+    std::size_t sender_threads = 1;
+
+    // Whether the service passed to the listener takes requests from several
+    // threads at once. Unless set, requests are made one at a time and
+    // sender_threads only overlaps the listener's own work with them, so it
+    // is the two together that report faster; SyntheticRunWithSenderPool in
+    // benchmarks/ compares both settings against a slow server.
+    bool concurrent_requests = false;
+
+    // Retry failed requests and give up on a server that is down, instead of
+    // letting the first failure end reporting. Ignored in spool mode. Unless
+    // asynchronous is set the waits between attempts hold up the tests.
+    retry_policy retry;
+
+    // Collect failure logs into batches before reporting them. Each entry
+    // keeps its own time and level. Batches only take fewer queue slots; the
+    // server still gets a request per entry, and logs of a running test show
+    // up as much as log_batch_delay later.
+    bool batch_logs = false;
+
+    // A batch is sent once it holds this many entries, this many bytes of
+    // messages or its oldest entry has waited this long, even when nothing
+    // else is reported. It is always sent before the item it belongs to
+    // ends.
+    std::size_t log_batch_entries = 256;
+    std::size_t log_batch_bytes = 64 * 1024;
+    std::chrono::milliseconds log_batch_delay = std::chrono::seconds(1);
+
+    // Bytes of a failure message logged, or zero for no limit. A longer
+    // message is cut at a character boundary and ends with a note of how
+    // many bytes were left out.
+    std::size_t log_message_limit = 64 * 1024;
+
+    // Capture what each test writes to stdout and stderr, still showing it on
+    // the console, and log it to the tests that fail. Of each test's
+    // output the first capture_head_bytes and the last capture_tail_bytes are
+    // kept. Needs pipes, so is not available on Windows.
+    bool capture_output = false;
+    std::size_t capture_head_bytes = 16 * 1024;
+    std::size_t capture_tail_bytes = 48 * 1024;
+
+    // Entries logged with reportportal::gtest::log that can wait for the
+    // listener to collect them. Further entries are dropped and counted, and
+    // the count is printed when the test program ends.
+    std::size_t test_log_capacity = 1024;
+
+    // Report each test only once it has ended, as a single event carrying
+    // its begin, its failure logs and its end, instead of an event at either
+    // end. Halves the events of a mostly passing run; the trade-off is that a
+    // test the program crashes in is never reported. The logs of a deferred
+    // test travel with it, so they are neither batched nor reported as the
+    // assertions fail.
+    bool defer_tests = false;
+
+    // For stress runs with GTEST_FLAG(repeat): report each suite and test
+    // once for all iterations instead of once per iteration. A test's item
+    // ends when the program does, with its outcomes and durations over the
+    // iterations logged and failed if any iteration failed. Only the logs of
+    // failing iterations are reported, once the iteration has ended.
+    // Overrides defer_tests and summarize_passes.
+    bool aggregate_repeats = false;
+
+    // Report only tests that fail or are skipped as items of their own, the
+    // way defer_tests does. Passing tests are left out, each suite instead
+    // logging how many of its tests passed and how long they took, followed
+    // by the name and duration of each. What passing tests logged is not
+    // reported.
+    bool summarize_passes = false;
+
+    // When set, events are appended to this journal file instead of being
+    // sent to the server. Upload it later with
+    // reportportal-agent-googletest-replay. Only one process may write to a
+    // journal at a time.
+    std::string spool_path;
+
+    // Uuid of an existing launch to report into, so the shards of a sharded
+    // run all end up in one launch. A new launch is started when empty.
+    std::string launch_uuid;
+
+    // Whether this process finishes the launch named by launch_uuid. Only
+    // one process should, after every other shard is done; alternatively
+    // leave it to reportportal-agent-googletest-launch finish.
+    bool finish_launch = false;
+
+    // Shard this process runs, used to tell the shards apart in the report.
+    // Ignored unless total_shards is above one.
+    int shard_index = 0;
+    int total_shards = 0;
+
+    // When the test program ends, write the listener's metrics as JSON to
+    // this file and/or print a summary of them to stdout. A file that can not
+    // be written is reported on stderr.
+    std::string metrics_path;
+    bool print_metrics = false;
+};
+
+// Fills in the sharding options from the environment: RP_LAUNCH_UUID,
+// RP_FINISH_LAUNCH (1 or 0) and gtest's own GTEST_SHARD_INDEX and
+// GTEST_TOTAL_SHARDS. Variables that are not set leave options untouched.
+void apply_environment(listener_options& options);
+
+}
+}
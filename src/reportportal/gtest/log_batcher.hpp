@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <reportportal/gtest/ireporter.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Holds back log entries and reports them together once enough of them have
+// piled up, once they have waited long enough or once the item they belong to
+// ends, whichever comes first. A timer thread sends a batch whose delay is up
+// when nothing else is reported to do so.
+//
+// A batch is a single log event whose entries keep their own item, level and
+// time; a test with hundreds of failed assertions then costs the queue one
+// event instead of hundreds. It saves no requests: service_reporter still
+// makes one per entry, as the client has no way of sending several at once.
+// Entries wait for up to max_delay, so logs streamed while a test runs show up
+// that much later.
+class log_batcher : public ireporter
+{
+    public:
+        log_batcher(
+            std::unique_ptr<ireporter> target,
+            std::size_t max_entries,
+            std::size_t max_bytes,
+            std::chrono::milliseconds max_delay);
+
+        // Drops the logs still held back.
+        ~log_batcher() override;
+
+        log_batcher(const log_batcher&) = delete;
+        log_batcher& operator=(const log_batcher&) = delete;
+
+        void report(const event& e) override;
+
+        // Rethrows the first error the timer thread ran into.
+        void flush() override;
+
+        bool flush_until(std::chrono::steady_clock::time_point deadline) override;
+
+        // Held back logs are newer than anything the target still has, so
+        // they are handed over last.
+        uint64_t abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) override;
+
+        // Number of log entries being held back.
+        std::size_t pending() const;
+
+        void collect(reporter_metrics& metrics) const override;
+
+    private:
+        bool is_pending(item_handle item) const;
+        void send_pending(ireporter& to);
+        void rethrow_error();
+        void run_timer();
+
+        std::unique_ptr<ireporter> _target;
+        const std::size_t _max_entries;
+        const std::size_t _max_bytes;
+        const std::chrono::milliseconds _max_delay;
+
+        event _pending;
+        std::size_t _pending_bytes = 0;
+        std::chrono::steady_clock::time_point _oldest;
+
+        event _batch;
+
+        // Held while the batch is reported, so the timer's batches stay in
+        // order with everything else.
+        mutable std::mutex _mutex;
+        std::condition_variable _changed;
+        bool _stopping = false;
+        std::exception_ptr _error;
+        std::thread _timer;
+};
+
+}
+}
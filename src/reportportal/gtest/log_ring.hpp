@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <reportportal/test_item.hpp>
+
+#include <reportportal/gtest/event.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Bounded queue of log entries that any number of threads push to without
+// taking a lock, for a single consumer to pop from. Each slot carries a
+// sequence number telling producers and the consumer whose turn it is, so a
+// push is one compare and swap on the tail plus copying the message into the
+// slot, and threads logging at the same time do not wait for each other.
+//
+// A push into a full ring drops the entry and counts it rather than waiting,
+// so a logging thread never does the consumer's work or waits for it.
+// Messages are assigned into the slots' strings and popped by swapping
+// strings, so once the ring has been round a few times logging does not
+// allocate.
+class log_ring
+{
+    public:
+        // capacity is rounded up to a power of two.
+        explicit log_ring(std::size_t capacity);
+
+        // Uninstalls the ring.
+        ~log_ring();
+
+        log_ring(const log_ring&) = delete;
+        log_ring& operator=(const log_ring&) = delete;
+
+        // May be called from any thread. Returns false when the ring is full
+        // and the entry was dropped.
+        bool push(report_portal::log_level level, std::string_view message);
+
+        // Moves the oldest entry into entry, leaving its item alone. Returns
+        // false when the ring is empty. Only one thread may pop at a time.
+        bool pop(log_entry& entry);
+
+        std::size_t capacity() const;
+
+        // Entries dropped because the ring was full.
+        uint64_t dropped() const;
+
+        // Stops log from writing to the ring if it is the installed one, and
+        // returns once no call of log uses it anymore.
+        void uninstall();
+
+    private:
+        struct slot;
+
+        std::unique_ptr<slot[]> _slots;
+        const std::size_t _mask;
+        alignas(64) std::atomic<std::size_t> _tail{0};
+        alignas(64) std::size_t _head = 0;
+        std::atomic<uint64_t> _dropped{0};
+};
+
+// Logs message to the ReportPortal item that is running, usually the test
+// whose body calls it. May be called from any thread of the test program; the
+// event_listener collects the entries when gtest next calls it, e.g. when an
+// assertion fails or the test ends, and entries logged by threads outliving a
+// test go to whatever runs next. Returns false when the entry was dropped
+// because no event_listener is installed or its ring is full; the listener
+// prints how many were dropped when the test program ends.
+bool log(report_portal::log_level level, std::string_view message);
+
+// Makes ring the one log writes to, or none when null. Used by the
+// event_listener. The ring that was installed before may still be in use by
+// calls of log that began before; see log_ring::uninstall.
+void set_log_ring(log_ring* ring);
+
+}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Recycles storage for objects of type T. Memory is taken from the heap in
+// blocks of block_size objects and slots freed by destroy are handed out again
+// by the next create, so once the pool has grown to the number of objects alive
+// at the same time creating and destroying them costs no allocations.
+//
+// Every object created must be destroyed before the pool itself is.
+template <typename T>
+class object_pool
+{
+    public:
+        explicit object_pool(std::size_t block_size = 64)
+          : _block_size(block_size)
+        {
+            if (block_size == 0) {
+                throw std::invalid_argument("object_pool needs a block size of at least one");
+            }
+        }
+
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+
+        template <typename... Args>
+        T* create(Args&&... args) {
+            if (!_free) {
+                grow();
+            }
+
+            slot* available = _free;
+            _free = available->next;
+
+            try {
+                T* object = new (available->storage) T(std::forward<Args>(args)...);
+                ++_size;
+                return object;
+            } catch (...) {
+                available->next = _free;
+                _free = available;
+                throw;
+            }
+        }
+
+        void destroy(T* object) {
+            if (!object) {
+                return;
+            }
+
+            object->~T();
+
+            slot* freed = reinterpret_cast<slot*>(object);
+            freed->next = _free;
+            _free = freed;
+            --_size;
+        }
+
+        // Number of objects currently alive.
+        std::size_t size() const {
+            return _size;
+        }
+
+        // Number of objects the pool can hold without allocating.
+        std::size_t capacity() const {
+            return _blocks.size() * _block_size;
+        }
+
+    private:
+        union slot
+        {
+            slot* next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        void grow() {
+            _blocks.push_back(std::unique_ptr<slot[]>(new slot[_block_size]));
+
+            slot* block = _blocks.back().get();
+            for (std::size_t i = 0; i < _block_size; ++i) {
+                block[i].next = _free;
+                _free = &block[i];
+            }
+        }
+
+        const std::size_t _block_size;
+        std::vector<std::unique_ptr<slot[]> > _blocks;
+        slot* _free = nullptr;
+        std::size_t _size = 0;
+};
+
+}
+}
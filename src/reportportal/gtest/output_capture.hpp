@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Captures what the test program writes to stdout and stderr, child processes
+// included, while still passing it on to the console. Both are redirected into
+// pipes that a background thread reads, writes through to the original file
+// descriptors and keeps in a fixed amount of memory: the first head_bytes and
+// the last tail_bytes since the capture was last restarted, with a note of how
+// much in between was skipped. However chatty a test is, the capture never
+// grows past that, and keeping it does not allocate.
+//
+// Only available where pipes and poll are; elsewhere the constructor throws.
+class output_capture
+{
+    public:
+        output_capture(std::size_t head_bytes, std::size_t tail_bytes);
+
+        // Puts stdout and stderr back the way they were.
+        ~output_capture();
+
+        output_capture(const output_capture&) = delete;
+        output_capture& operator=(const output_capture&) = delete;
+
+        // Starts over, forgetting everything written so far.
+        void restart();
+
+        // Waits, for up to a second, for everything written so far to be
+        // read and replaces text with what was kept since the last restart.
+        // Returns the number of bytes written in that time, kept or not.
+        uint64_t take(std::string& text);
+
+    private:
+        void restore(std::size_t streams);
+        void wait_until_read(std::unique_lock<std::mutex>& lock);
+        void run();
+        void read_from(std::size_t stream);
+        void keep(const char* data, std::size_t size);
+
+        const std::size_t _head_bytes;
+        const std::size_t _tail_bytes;
+
+        // stdout and stderr: the descriptors redirected, copies of where they
+        // pointed before and the ends of the pipes the thread reads.
+        std::array<int, 2> _fds = {{1, 2}};
+        std::array<int, 2> _originals = {{-1, -1}};
+        std::array<int, 2> _pipes = {{-1, -1}};
+        std::array<int, 2> _wake = {{-1, -1}};
+
+        std::mutex _mutex;
+        std::condition_variable _read;
+        bool _reading = false;
+
+        // Reads completed and bytes taken out of the pipes since the capture
+        // began, for telling when what was written up to some point is read.
+        uint64_t _reads = 0;
+        uint64_t _consumed = 0;
+        std::string _head;
+        std::string _tail;
+        std::size_t _tail_begin = 0;
+        std::size_t _tail_size = 0;
+        uint64_t _total = 0;
+
+        std::array<char, 4096> _buffer;
+        std::thread _thread;
+};
+
+}
+}
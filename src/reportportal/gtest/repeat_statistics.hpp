@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <reportportal/test_item.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Outcomes and durations of one test over the iterations of a repeated run.
+// Every duration is kept, eight bytes an iteration, so the percentiles are
+// exact. Skipped iterations did not run the test, so only their outcome is
+// counted and the durations are those of the iterations that passed or failed.
+class repeat_statistics
+{
+    public:
+        void record(report_portal::test_item_status status, std::chrono::milliseconds duration);
+
+        uint64_t runs() const;
+        uint64_t passed() const;
+        uint64_t failed() const;
+        uint64_t skipped() const;
+
+        // Zero when no iteration passed or failed.
+        std::chrono::milliseconds min() const;
+        std::chrono::milliseconds mean() const;
+        std::chrono::milliseconds max() const;
+        std::chrono::milliseconds percentile(double fraction) const;
+
+        // Failed if any iteration failed, passed if any passed and skipped
+        // otherwise.
+        report_portal::test_item_status status() const;
+
+        // Appends a summary of the statistics for a log entry.
+        void describe(std::string& out) const;
+
+    private:
+        uint64_t _passed = 0;
+        uint64_t _failed = 0;
+        uint64_t _skipped = 0;
+        std::chrono::milliseconds _total = std::chrono::milliseconds::zero();
+        std::vector<std::chrono::milliseconds> _durations;
+};
+
+}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <reportportal/gtest/ireporter.hpp>
+#include <reportportal/gtest/journal.hpp>
+#include <reportportal/gtest/listener_options.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Retries events the wrapped reporter failed to deliver, waiting a jittered,
+// exponentially growing time between attempts, and never lets an error reach
+// the test program: events that fail every attempt are counted and skipped.
+//
+// When breaker_threshold events in a row have failed, the server is taken to
+// be down for the rest of the run. So it is at once when the launch's begin
+// fails, as nothing after it could be delivered, and when an item's begin
+// fails while there is a fallback journal, so the journal gets the item and
+// everything under it. From then on events go to the fallback journal if
+// there is one. The journal starts with the launch and every item
+// still running at that point, so replaying it recreates them in a new launch
+// (or in the same one, when the launch was joined by uuid) and the report
+// carries on where the server stopped taking it.
+//
+// Only errors the policy deems retryable are retried; anything else is
+// rethrown at once, as with no retrying_reporter at all. With no fallback
+// journal, an item whose begin failed every attempt is remembered, and the
+// events of it and of the items under it are skipped without a request, so
+// one lost suite costs one event's retries rather than each of its tests'.
+//
+// A retried event has to leave the target as it was before the failed
+// attempt, which service_reporter does. A begin the server took although the
+// response was lost is made again, as the client does not let the request's
+// uuid be chosen up front, so such a retry shows up twice in the report.
+//
+// May be reported to from several threads at once, like service_reporter.
+class retrying_reporter : public ireporter
+{
+    public:
+        retrying_reporter(std::unique_ptr<ireporter> target, const retry_policy& policy);
+
+        void report(const event& e) override;
+
+        void flush() override;
+
+        bool flush_until(std::chrono::steady_clock::time_point deadline) override;
+
+        uint64_t abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) override;
+
+        void collect(reporter_metrics& metrics) const override;
+
+        // Whether the server has been given up on.
+        bool open() const;
+
+    private:
+        bool deliver(const event& e);
+        void divert(const event& e);
+        void track(const event& e);
+
+        bool retryable(const std::exception& error) const;
+
+        // Whether e belongs to an abandoned item and is to be dropped. Of a
+        // log event only the entries of abandoned items are, the others are
+        // copied to remaining.
+        bool skip(const event& e, event& remaining);
+
+        std::unique_ptr<ireporter> _target;
+        const retry_policy _policy;
+
+        std::atomic<bool> _open{false};
+        std::atomic<int> _consecutive_failures{0};
+
+        // The launch and the items running in it, in the order they began,
+        // for starting the fallback journal. Only kept when there is one.
+        std::mutex _mutex;
+        event _launch;
+        std::vector<event> _running;
+        std::unique_ptr<journal_writer> _fallback;
+
+        // The launch and items whose begin was abandoned, until they end.
+        std::mutex _abandoned_mutex;
+        std::vector<item_handle> _abandoned_items;
+        std::atomic<bool> _any_abandoned{false};
+
+        std::atomic<uint64_t> _retries{0};
+        std::atomic<uint64_t> _abandoned{0};
+        std::atomic<uint64_t> _diverted{0};
+};
+
+}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <reportportal/gtest/async_reporter.hpp>
+#include <reportportal/gtest/ireporter.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Reports events from several background threads at once. Each test suite
+// below the top level item is handed to one lane, the least busy one when it
+// begins, and all of its tests and logs follow it there, so events for an item
+// and its parents are still delivered in order while independent suites are
+// reported in parallel. A suite never spreads over several lanes, so a run
+// whose tests are in one suite is reported by one lane.
+//
+// The launch and the items directly under it are shared by every suite, so
+// their events wait for all lanes to drain and are then reported on the
+// calling thread.
+//
+// The target is called from several threads and has to allow that for events
+// of different items, as service_reporter does. Whether requests to the
+// server then overlap is up to the service_reporter's concurrent_requests.
+class sender_pool : public ireporter
+{
+    public:
+        // Starts workers lanes, each queueing up to capacity events within an
+        // equal share of memory_budget, as an async_reporter with the given
+        // overflow policy does.
+        sender_pool(
+            std::unique_ptr<ireporter> target,
+            std::size_t workers,
+            std::size_t capacity,
+            std::size_t memory_budget = 0,
+            overflow_policy overflow = overflow_policy::block,
+            const std::string& spill_path = std::string());
+
+        // Delivers everything still queued before returning.
+        ~sender_pool() override;
+
+        sender_pool(const sender_pool&) = delete;
+        sender_pool& operator=(const sender_pool&) = delete;
+
+        void report(const event& e) override;
+
+        // Waits until every lane has delivered everything queued so far and
+        // flushes the target. Rethrows the first error a lane ran into.
+        void flush() override;
+
+        bool flush_until(std::chrono::steady_clock::time_point deadline) override;
+
+        // Pauses every lane, abandons the target and then the lanes one after
+        // the other, so overflow is only ever called from one thread at a time.
+        uint64_t abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) override;
+
+        // Number of events waiting to be delivered.
+        std::size_t pending() const;
+
+        void collect(reporter_metrics& metrics) const override;
+
+    private:
+        static constexpr std::size_t no_lane = static_cast<std::size_t>(-1);
+
+        std::size_t lane_of(item_handle item) const;
+        std::size_t least_busy_lane() const;
+        void report_inline(const event& e);
+        void log(const event& e);
+        void drain();
+
+        std::unique_ptr<ireporter> _target;
+        std::vector<std::unique_ptr<async_reporter> > _lanes;
+
+        // Items that are reported on the calling thread: the launch and the
+        // items directly under it.
+        item_handle _launch_handle = null_handle;
+        std::vector<item_handle> _shared_items;
+
+        // Lane of every other running item.
+        std::unordered_map<item_handle, std::size_t> _item_lanes;
+
+        // Log entries split up by lane, reused from one log event to the next.
+        std::vector<event> _lane_logs;
+        event _shared_logs;
+};
+
+}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <reportportal/iservice.hpp>
+#include <reportportal/launch.hpp>
+#include <reportportal/test_item.hpp>
+
+#include <reportportal/gtest/ireporter.hpp>
+#include <reportportal/gtest/object_pool.hpp>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Delivers events to ReportPortal through a report_portal::iservice on the
+// calling thread. Handles are resolved to the launch and test items created
+// for them.
+//
+// Test items live in a pool that is recycled from one test to the next, and
+// only the handful of items that are running at the same time are looked up,
+// so the cost per test stays constant and does not involve the allocator.
+//
+// Events for different test items may be reported from several threads at
+// once, as long as the events for one item and its parent arrive in order and
+// launch events are not reported alongside anything else. Requests are made
+// one at a time unless the service is said to allow concurrent ones; the
+// client does not promise that report_portal::service does.
+//
+// A begin or end that fails leaves things as they were before it, so the same
+// event can be reported again to retry it. Events that could never succeed,
+// such as one for an unknown handle, throw a std::logic_error instead of the
+// client's errors, so they are not retried.
+//
+// Copies of the begin events of the launch and the items still running are
+// kept, in the order they began, so abandon can tell where the server stands.
+// The copies reuse their storage from one item to the next.
+class service_reporter : public ireporter
+{
+    public:
+        explicit service_reporter(report_portal::iservice& service, bool concurrent_requests = false);
+        ~service_reporter() override;
+
+        service_reporter(const service_reporter&) = delete;
+        service_reporter& operator=(const service_reporter&) = delete;
+
+        void report(const event& e) override;
+
+        void flush() override;
+
+        // Reports the begin events of the running launch and items to
+        // overflow, so the events handed over after them can be replayed on
+        // their own. Returns zero as nothing is taken from the service.
+        uint64_t abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) override;
+
+        // Counts one request per launch or item begun or ended and per log
+        // entry. A completed item counts as begun and ended.
+        void collect(reporter_metrics& metrics) const override;
+
+    private:
+        using item_list = std::vector<std::pair<item_handle, report_portal::test_item*> >;
+
+        void dispatch(const event& e);
+        void begin_launch(const event& e);
+        void end_launch(const event& e);
+        void leave_launch(const event& e);
+        void begin_item(const event& e);
+        void end_item(
+            item_handle handle,
+            std::chrono::system_clock::time_point time,
+            report_portal::test_item_status status);
+        void log(const event& e);
+        void complete_item(const event& e);
+
+        // Held around each request unless concurrent requests are allowed.
+        std::unique_lock<std::mutex> lock_request();
+
+        // find_item, destroy_items, remember and forget expect _mutex to be
+        // held.
+        item_list::iterator find_item(item_handle handle);
+        void destroy_items();
+        void remember(const event& e);
+        void forget(item_handle handle);
+
+        report_portal::iservice& _service;
+        const bool _concurrent_requests;
+        std::mutex _request_mutex;
+        item_handle _launch_handle = null_handle;
+        std::unique_ptr<report_portal::launch> _launch;
+
+        // Guards the item pool and list, not the items themselves.
+        std::mutex _mutex;
+        object_pool<report_portal::test_item> _item_pool;
+        item_list _items;
+        event _launch_event;
+        std::vector<event> _begun;
+        std::size_t _begun_count = 0;
+
+        std::atomic<uint64_t> _requests{0};
+        std::atomic<uint64_t> _failed_requests{0};
+};
+
+}
+}
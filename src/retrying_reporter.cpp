@@ -0,0 +1,302 @@
+#include <reportportal/gtest/retrying_reporter.hpp>
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+// Full jitter: a random wait between zero and the exponential backoff, so
+// senders that failed together do not retry together.
+static std::chrono::milliseconds backoff(const retry_policy& policy, int retry)
+{
+    thread_local std::minstd_rand random(std::random_device{}());
+
+    std::chrono::milliseconds ceiling = policy.base_delay;
+    for (int i = 1; i < retry && ceiling < policy.max_delay; ++i) {
+        ceiling *= 2;
+    }
+    ceiling = std::min(ceiling, policy.max_delay);
+    if (ceiling.count() <= 0) {
+        return std::chrono::milliseconds(0);
+    }
+
+    std::uniform_int_distribution<std::chrono::milliseconds::rep> wait(0, ceiling.count());
+    return std::chrono::milliseconds(wait(random));
+}
+
+retrying_reporter::retrying_reporter(std::unique_ptr<ireporter> target, const retry_policy& policy)
+  : _target(std::move(target)),
+    _policy(policy)
+{
+    if (!_target) {
+        throw std::invalid_argument("retrying_reporter needs a reporter to forward to");
+    }
+
+    if (policy.attempts < 1) {
+        throw std::invalid_argument("retrying_reporter needs at least one attempt per event");
+    }
+}
+
+void retrying_reporter::report(const event& e) {
+    if (_open) {
+        divert(e);
+        return;
+    }
+
+    if (_any_abandoned) {
+        event remaining;
+        if (skip(e, remaining)) {
+            if (!remaining.logs.empty()) {
+                report(remaining);
+            }
+            return;
+        }
+    }
+
+    if (deliver(e)) {
+        _consecutive_failures = 0;
+        track(e);
+        return;
+    }
+
+    // Nothing under a launch that never began can be delivered, and nothing
+    // under an item that never began can be replayed unless the journal gets
+    // the item, so neither waits for the threshold.
+    const bool orphaning = e.type == event_type::begin_launch || e.type == event_type::begin_item;
+    const bool breaking = orphaning && (e.type == event_type::begin_launch || !_policy.fallback_path.empty());
+    const int failures = ++_consecutive_failures;
+    if (_policy.breaker_threshold > 0 && (failures >= _policy.breaker_threshold || breaking)) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_open && !_policy.fallback_path.empty()) {
+            // Start the journal with what the events after this one need.
+            _fallback = std::make_unique<journal_writer>(_policy.fallback_path);
+            if (_launch.item != null_handle) {
+                _fallback->report(_launch);
+                ++_diverted;
+            }
+            for (const event& running : _running) {
+                _fallback->report(running);
+                ++_diverted;
+            }
+        }
+        _open = true;
+    }
+
+    if (_open) {
+        divert(e);
+        return;
+    }
+
+    ++_abandoned;
+
+    if (orphaning) {
+        std::lock_guard<std::mutex> lock(_abandoned_mutex);
+        _abandoned_items.push_back(e.item);
+        _any_abandoned = true;
+    }
+}
+
+void retrying_reporter::flush() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_fallback) {
+            _fallback->flush();
+        }
+    }
+
+    if (!_open) {
+        try {
+            _target->flush();
+        } catch (...) {
+            // Whatever did not make it has already been counted.
+        }
+    }
+}
+
+bool retrying_reporter::flush_until(std::chrono::steady_clock::time_point deadline) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_fallback) {
+            _fallback->flush();
+        }
+    }
+
+    if (_open) {
+        return true;
+    }
+
+    try {
+        return _target->flush_until(deadline);
+    } catch (...) {
+        return true;
+    }
+}
+
+// Once the breaker is open the fallback journal picks up where the server
+// stopped, so the server's running items are of no use to overflow.
+uint64_t retrying_reporter::abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) {
+    if (_open) {
+        return 0;
+    }
+
+    return _target->abandon(overflow, deadline);
+}
+
+void retrying_reporter::collect(reporter_metrics& metrics) const {
+    metrics.retries += _retries;
+    metrics.abandoned_events += _abandoned;
+    metrics.fallback_events += _diverted;
+    _target->collect(metrics);
+}
+
+bool retrying_reporter::open() const {
+    return _open;
+}
+
+bool retrying_reporter::retryable(const std::exception& error) const {
+    if (_policy.retryable) {
+        return _policy.retryable(error);
+    }
+
+    return dynamic_cast<const std::logic_error*>(&error) == nullptr;
+}
+
+bool retrying_reporter::deliver(const event& e) {
+    for (int attempt = 1; ; ++attempt) {
+        try {
+            _target->report(e);
+            return true;
+        } catch (const std::exception& error) {
+            if (!retryable(error)) {
+                throw;
+            }
+            if (attempt >= _policy.attempts || _open) {
+                return false;
+            }
+        }
+
+        ++_retries;
+        std::this_thread::sleep_for(backoff(_policy, attempt));
+    }
+}
+
+void retrying_reporter::divert(const event& e) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_fallback) {
+        _fallback->report(e);
+        ++_diverted;
+    } else {
+        ++_abandoned;
+    }
+}
+
+bool retrying_reporter::skip(const event& e, event& remaining) {
+    std::lock_guard<std::mutex> lock(_abandoned_mutex);
+    const auto abandoned = [this](item_handle item) {
+        return std::find(_abandoned_items.begin(), _abandoned_items.end(), item) != _abandoned_items.end();
+    };
+
+    switch (e.type) {
+        case event_type::begin_launch:
+            // A new launch owes nothing to the items of the last one.
+            _abandoned_items.clear();
+            _any_abandoned = false;
+            return false;
+        case event_type::end_launch:
+        case event_type::leave_launch:
+            if (!abandoned(e.item)) {
+                return false;
+            }
+            _abandoned_items.clear();
+            _any_abandoned = false;
+            break;
+        case event_type::begin_item:
+            if (!abandoned(e.parent)) {
+                return false;
+            }
+            _abandoned_items.push_back(e.item);
+            break;
+        case event_type::end_item: {
+            const auto found = std::find(_abandoned_items.begin(), _abandoned_items.end(), e.item);
+            if (found == _abandoned_items.end()) {
+                return false;
+            }
+            _abandoned_items.erase(found);
+            _any_abandoned = !_abandoned_items.empty();
+            break;
+        }
+        case event_type::complete_item:
+            if (!abandoned(e.parent)) {
+                return false;
+            }
+            break;
+        case event_type::log: {
+            std::size_t dropped = 0;
+            for (const log_entry& entry : e.logs) {
+                if (abandoned(entry.item)) {
+                    ++dropped;
+                }
+            }
+            if (dropped == 0) {
+                return false;
+            }
+
+            remaining.type = event_type::log;
+            for (const log_entry& entry : e.logs) {
+                if (!abandoned(entry.item)) {
+                    remaining.logs.push_back(entry);
+                }
+            }
+            // The event counts as abandoned only when none of it is left.
+            if (remaining.logs.empty()) {
+                ++_abandoned;
+            }
+            return true;
+        }
+    }
+
+    ++_abandoned;
+    return true;
+}
+
+// Keeps the launch and running items up to date for the fallback journal.
+void retrying_reporter::track(const event& e) {
+    if (_policy.breaker_threshold <= 0 || _policy.fallback_path.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    switch (e.type) {
+        case event_type::begin_launch:
+            _launch = e;
+            _running.clear();
+            break;
+        case event_type::end_launch:
+        case event_type::leave_launch:
+            _launch = event();
+            _running.clear();
+            break;
+        case event_type::begin_item:
+            _running.push_back(e);
+            _running.back().logs.clear();
+            break;
+        case event_type::end_item:
+            _running.erase(
+                std::remove_if(_running.begin(), _running.end(), [&e](const event& running) {
+                    return running.item == e.item;
+                }),
+                _running.end());
+            break;
+        case event_type::log:
+        case event_type::complete_item:
+            break;
+    }
+}
+
+}
+}
@@ -0,0 +1,242 @@
+#include <reportportal/gtest/sender_pool.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+namespace
+{
+
+// Lets every lane report to the same target. Flushing the target is left to
+// the pool once all lanes have drained.
+class lane_target : public ireporter
+{
+    public:
+        explicit lane_target(ireporter& target)
+          : _target(target)
+        {}
+
+        void report(const event& e) override {
+            _target.report(e);
+        }
+
+        void flush() override {
+        }
+
+    private:
+        ireporter& _target;
+};
+
+}
+
+sender_pool::sender_pool(
+    std::unique_ptr<ireporter> target,
+    std::size_t workers,
+    std::size_t capacity,
+    std::size_t memory_budget,
+    overflow_policy overflow,
+    const std::string& spill_path)
+  : _target(std::move(target)),
+    _lane_logs(workers)
+{
+    if (!_target) {
+        throw std::invalid_argument("sender_pool needs a reporter to forward to");
+    }
+
+    if (workers == 0) {
+        throw std::invalid_argument("sender_pool needs at least one worker");
+    }
+
+    // A share rounded down to zero would lift the limit altogether.
+    const std::size_t lane_budget = memory_budget == 0 ? 0 : std::max<std::size_t>(memory_budget / workers, 1);
+    for (std::size_t i = 0; i < workers; ++i) {
+        // Lanes spill from the calling thread, one after the other, so each
+        // finds its own unused file next to spill_path.
+        _lanes.push_back(std::make_unique<async_reporter>(
+            std::make_unique<lane_target>(*_target),
+            capacity,
+            lane_budget,
+            overflow,
+            spill_path));
+        _lane_logs[i].type = event_type::log;
+    }
+    _shared_logs.type = event_type::log;
+}
+
+sender_pool::~sender_pool() {
+    // The lanes report into _target, so they have to be gone first.
+    _lanes.clear();
+}
+
+void sender_pool::report(const event& e) {
+    switch (e.type) {
+        case event_type::begin_launch:
+            report_inline(e);
+            _launch_handle = e.item;
+            break;
+        case event_type::end_launch:
+        case event_type::leave_launch:
+            report_inline(e);
+            _launch_handle = null_handle;
+            _shared_items.clear();
+            _item_lanes.clear();
+            break;
+        case event_type::begin_item:
+        case event_type::complete_item: {
+            // Completed items are over once reported, so they are not
+            // remembered; their logs travel with them.
+            const bool running = e.type == event_type::begin_item;
+            if (e.parent == _launch_handle) {
+                report_inline(e);
+                if (running) {
+                    _shared_items.push_back(e.item);
+                }
+                break;
+            }
+
+            std::size_t lane = lane_of(e.parent);
+            if (lane == no_lane) {
+                const bool top_level = std::find(_shared_items.begin(), _shared_items.end(), e.parent) != _shared_items.end();
+                if (!top_level) {
+                    // Let the target complain about the unknown parent.
+                    report_inline(e);
+                    break;
+                }
+
+                lane = least_busy_lane();
+            }
+
+            if (running) {
+                _item_lanes.emplace(e.item, lane);
+            }
+            _lanes[lane]->report(e);
+            break;
+        }
+        case event_type::end_item: {
+            const auto found = _item_lanes.find(e.item);
+            if (found == _item_lanes.end()) {
+                report_inline(e);
+                _shared_items.erase(std::remove(_shared_items.begin(), _shared_items.end(), e.item), _shared_items.end());
+                break;
+            }
+
+            const std::size_t lane = found->second;
+            _item_lanes.erase(found);
+            _lanes[lane]->report(e);
+            break;
+        }
+        case event_type::log:
+            log(e);
+            break;
+    }
+}
+
+void sender_pool::flush() {
+    drain();
+    _target->flush();
+}
+
+bool sender_pool::flush_until(std::chrono::steady_clock::time_point deadline) {
+    for (auto& lane : _lanes) {
+        if (!lane->flush_until(deadline)) {
+            return false;
+        }
+    }
+
+    return _target->flush_until(deadline);
+}
+
+uint64_t sender_pool::abandon(ireporter& overflow, std::chrono::steady_clock::time_point deadline) {
+    for (auto& lane : _lanes) {
+        lane->pause(deadline);
+    }
+
+    uint64_t handed_over = _target->abandon(overflow, deadline);
+    for (auto& lane : _lanes) {
+        handed_over += lane->abandon(overflow, deadline);
+    }
+    return handed_over;
+}
+
+std::size_t sender_pool::pending() const {
+    std::size_t count = 0;
+    for (const auto& lane : _lanes) {
+        count += lane->pending();
+    }
+    return count;
+}
+
+// The lanes share the target, so it is collected from once.
+void sender_pool::collect(reporter_metrics& metrics) const {
+    for (const auto& lane : _lanes) {
+        lane->collect(metrics);
+    }
+
+    _target->collect(metrics);
+}
+
+std::size_t sender_pool::lane_of(item_handle item) const {
+    const auto found = _item_lanes.find(item);
+    return found == _item_lanes.end() ? no_lane : found->second;
+}
+
+std::size_t sender_pool::least_busy_lane() const {
+    std::size_t best = 0;
+    std::size_t best_pending = _lanes[0]->pending();
+    for (std::size_t i = 1; i < _lanes.size() && best_pending > 0; ++i) {
+        const std::size_t lane_pending = _lanes[i]->pending();
+        if (lane_pending < best_pending) {
+            best = i;
+            best_pending = lane_pending;
+        }
+    }
+    return best;
+}
+
+void sender_pool::report_inline(const event& e) {
+    drain();
+    _target->report(e);
+}
+
+// A log event may hold entries for items in different lanes, e.g. when logs
+// are batched, so each lane gets only the entries of its own items.
+void sender_pool::log(const event& e) {
+    for (const log_entry& entry : e.logs) {
+        const std::size_t lane = lane_of(entry.item);
+        if (lane == no_lane) {
+            _shared_logs.logs.push_back(entry);
+        } else {
+            _lane_logs[lane].logs.push_back(entry);
+        }
+    }
+
+    for (std::size_t i = 0; i < _lanes.size(); ++i) {
+        if (!_lane_logs[i].logs.empty()) {
+            _lanes[i]->report(_lane_logs[i]);
+            _lane_logs[i].logs.clear();
+        }
+    }
+
+    if (!_shared_logs.logs.empty()) {
+        try {
+            report_inline(_shared_logs);
+        } catch (...) {
+            _shared_logs.logs.clear();
+            throw;
+        }
+        _shared_logs.logs.clear();
+    }
+}
+
+void sender_pool::drain() {
+    for (auto& lane : _lanes) {
+        lane->flush();
+    }
+}
+
+}
+}
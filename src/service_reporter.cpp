@@ -0,0 +1,293 @@
+#include <reportportal/gtest/service_reporter.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace reportportal
+{
+namespace gtest
+{
+
+service_reporter::service_reporter(report_portal::iservice& service, bool concurrent_requests)
+  : _service(service),
+    _concurrent_requests(concurrent_requests)
+{}
+
+service_reporter::~service_reporter() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    destroy_items();
+}
+
+void service_reporter::report(const event& e) {
+    if (e.type == event_type::log) {
+        _requests += e.logs.size();
+    } else if (e.type == event_type::complete_item) {
+        _requests += 2 + e.logs.size();
+    } else if (e.type != event_type::leave_launch) {
+        ++_requests;
+    }
+
+    try {
+        dispatch(e);
+    } catch (...) {
+        ++_failed_requests;
+        throw;
+    }
+}
+
+void service_reporter::flush() {
+}
+
+uint64_t service_reporter::abandon(ireporter& overflow, std::chrono::steady_clock::time_point) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_launch) {
+        overflow.report(_launch_event);
+        for (std::size_t i = 0; i < _begun_count; ++i) {
+            overflow.report(_begun[i]);
+        }
+    }
+    return 0;
+}
+
+void service_reporter::collect(reporter_metrics& metrics) const {
+    metrics.requests += _requests;
+    metrics.failed_requests += _failed_requests;
+}
+
+void service_reporter::dispatch(const event& e) {
+    switch (e.type) {
+        case event_type::begin_launch:
+            begin_launch(e);
+            break;
+        case event_type::end_launch:
+            end_launch(e);
+            break;
+        case event_type::begin_item:
+            begin_item(e);
+            break;
+        case event_type::end_item:
+            end_item(e.item, e.time, e.status);
+            break;
+        case event_type::log:
+            log(e);
+            break;
+        case event_type::leave_launch:
+            leave_launch(e);
+            break;
+        case event_type::complete_item:
+            complete_item(e);
+            break;
+    }
+}
+
+void service_reporter::begin_launch(const event& e) {
+    if (_launch) {
+        throw std::logic_error("Can not begin a launch while another one is running");
+    }
+
+    _launch = std::make_unique<report_portal::launch>(_service, e.name);
+    _launch->set_description(e.description);
+
+    // ReportPortal adds to the existing launch when starting a rerun of it.
+    if (!e.rerun_of.is_nil()) {
+        _launch->set_rerunof(e.rerun_of);
+    }
+
+    try {
+        std::unique_lock<std::mutex> request = lock_request();
+        _launch->start(e.time);
+    } catch (...) {
+        _launch.reset();
+        throw;
+    }
+    _launch_handle = e.item;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _launch_event = e;
+    _begun_count = 0;
+}
+
+void service_reporter::end_launch(const event& e) {
+    if (!_launch || e.item != _launch_handle) {
+        throw std::logic_error("Can not end a launch that has not begun");
+    }
+
+    {
+        std::unique_lock<std::mutex> request = lock_request();
+        _launch->end(e.time);
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    destroy_items();
+    _launch.reset();
+    _launch_handle = null_handle;
+}
+
+void service_reporter::leave_launch(const event& e) {
+    if (!_launch || e.item != _launch_handle) {
+        throw std::logic_error("Can not leave a launch that has not begun");
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    destroy_items();
+    _launch.reset();
+    _launch_handle = null_handle;
+}
+
+void service_reporter::begin_item(const event& e) {
+    if (!_launch) {
+        throw std::logic_error("Can not begin a test item outside of a launch");
+    }
+
+    report_portal::test_item* item = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (e.parent == _launch_handle) {
+            // Items directly under the launch are always suites.
+            item = _item_pool.create(*_launch, e.name);
+        } else {
+            item = _item_pool.create(*find_item(e.parent)->second, e.name, e.item_type);
+        }
+        _items.emplace_back(e.item, item);
+    }
+
+    item->set_description(e.description);
+    try {
+        std::unique_lock<std::mutex> request = lock_request();
+        item->start(e.time);
+    } catch (...) {
+        // Forget the item so the begin can be tried again.
+        std::lock_guard<std::mutex> lock(_mutex);
+        _items.erase(find_item(e.item));
+        _item_pool.destroy(item);
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    remember(e);
+}
+
+void service_reporter::end_item(
+    item_handle handle,
+    std::chrono::system_clock::time_point time,
+    report_portal::test_item_status status) {
+    report_portal::test_item* item = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto found = find_item(handle);
+        item = found->second;
+
+        // Forget the item while it is ending; a failed end puts it back.
+        *found = _items.back();
+        _items.pop_back();
+    }
+
+    try {
+        std::unique_lock<std::mutex> request = lock_request();
+        item->end(time, status);
+    } catch (...) {
+        // Keep the item so the end can be tried again. It is destroyed with
+        // the launch at the latest.
+        std::lock_guard<std::mutex> lock(_mutex);
+        _items.emplace_back(handle, item);
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _item_pool.destroy(item);
+    forget(handle);
+}
+
+void service_reporter::log(const event& e) {
+    for (const log_entry& entry : e.logs) {
+        report_portal::test_item* item = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            item = find_item(entry.item)->second;
+        }
+
+        std::unique_lock<std::mutex> request = lock_request();
+        item->log(entry.time, entry.level, entry.message);
+    }
+}
+
+// ReportPortal has no request for an item that has already ended, so it is
+// begun, logged to and ended in turn. An item still there from an earlier
+// attempt is not begun again.
+void service_reporter::complete_item(const event& e) {
+    bool begun = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        begun = std::any_of(_items.begin(), _items.end(), [&e](const item_list::value_type& item) {
+            return item.first == e.item;
+        });
+    }
+
+    if (!begun) {
+        begin_item(e);
+    }
+    log(e);
+    end_item(e.item, e.end_time, e.status);
+}
+
+std::unique_lock<std::mutex> service_reporter::lock_request() {
+    if (_concurrent_requests) {
+        return std::unique_lock<std::mutex>();
+    }
+
+    return std::unique_lock<std::mutex>(_request_mutex);
+}
+
+service_reporter::item_list::iterator service_reporter::find_item(item_handle handle) {
+    // Recently started items are the most likely to be looked up.
+    for (auto item = _items.rbegin(); item != _items.rend(); ++item) {
+        if (item->first == handle) {
+            return std::prev(item.base());
+        }
+    }
+
+    throw std::invalid_argument("Unknown test item handle " + std::to_string(handle));
+}
+
+void service_reporter::destroy_items() {
+    while (!_items.empty()) {
+        _item_pool.destroy(_items.back().second);
+        _items.pop_back();
+    }
+    _begun_count = 0;
+}
+
+void service_reporter::remember(const event& e) {
+    if (_begun_count == _begun.size()) {
+        _begun.emplace_back();
+    }
+
+    // Assigning member by member leaves the logs out and keeps the storage of
+    // the strings.
+    event& copy = _begun[_begun_count++];
+    copy.type = event_type::begin_item;
+    copy.item = e.item;
+    copy.parent = e.parent;
+    copy.time = e.time;
+    copy.name = e.name;
+    copy.description = e.description;
+    copy.item_type = e.item_type;
+}
+
+void service_reporter::forget(item_handle handle) {
+    const auto begin = _begun.begin();
+    const auto end = begin + _begun_count;
+    const auto found = std::find_if(begin, end, [handle](const event& e) {
+        return e.item == handle;
+    });
+
+    // Moving the copy to the back keeps the others in the order they began.
+    if (found != end) {
+        std::rotate(found, found + 1, end);
+        --_begun_count;
+    }
+}
+
+}
+}
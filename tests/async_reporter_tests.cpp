@@ -0,0 +1,276 @@
+#include <utils.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <reportportal/gtest/async_reporter.hpp>
+
+using reportportal::gtest::async_reporter;
+using reportportal::gtest::event;
+using reportportal::gtest::event_type;
+using reportportal::gtest::overflow_policy;
+
+namespace {
+
+class counting_reporter : public reportportal::gtest::ireporter
+{
+    public:
+        explicit counting_reporter(int& count)
+          : _count(count)
+        {}
+
+        void report(const event& e) override {
+            ++_count;
+        }
+
+        void flush() override {}
+
+    private:
+        int& _count;
+};
+
+event make_log(reportportal::gtest::item_handle item)
+{
+    event e;
+    e.type = event_type::log;
+    e.logs.resize(1);
+    e.logs[0].item = item;
+    e.logs[0].message = std::string(1000, 'x');
+    return e;
+}
+
+}
+
+TEST_CASE("Async reporter delivers events in order", "[async_reporter]")
+{
+    auto recorder = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *recorder;
+
+    // A tiny queue makes the test thread block on a full queue as well.
+    async_reporter reporter(std::move(recorder), 2);
+
+    const int event_count = 100;
+    for (int i = 0; i < event_count; ++i) {
+        reporter.report(make_event(event_type::begin_item, i + 1, reportportal::gtest::null_handle, "item " + std::to_string(i)));
+    }
+    reporter.flush();
+
+    REQUIRE(reporter.pending() == 0);
+    REQUIRE(recorded.flush_count == 1);
+    REQUIRE(recorded.events.size() == event_count);
+    for (int i = 0; i < event_count; ++i) {
+        REQUIRE(recorded.events[i].item == static_cast<reportportal::gtest::item_handle>(i + 1));
+        REQUIRE(recorded.events[i].name == "item " + std::to_string(i));
+    }
+}
+
+TEST_CASE("Async reporter delivers queued events on destruction", "[async_reporter]")
+{
+    int delivered = 0;
+    {
+        async_reporter reporter(std::make_unique<counting_reporter>(delivered), 16);
+        reporter.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle, "launch"));
+        reporter.report(make_event(event_type::end_launch, 1));
+    }
+
+    REQUIRE(delivered == 2);
+}
+
+TEST_CASE("Async reporter rethrows background errors on flush", "[async_reporter]")
+{
+    async_reporter reporter(std::make_unique<throwing_reporter>(), 4);
+    reporter.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle, "launch"));
+
+    REQUIRE_THROWS_AS(reporter.flush(), std::runtime_error);
+
+    SECTION("error is only reported once") {
+        REQUIRE_NOTHROW(reporter.flush());
+    }
+}
+
+TEST_CASE("Async reporter spills what does not fit", "[async_reporter]")
+{
+    const std::string spill_path = "async_reporter_tests.spill";
+    auto gate = std::make_unique<gated_reporter>();
+    gated_reporter& gated = *gate;
+
+    {
+        async_reporter reporter(std::move(gate), 2, 0, overflow_policy::spill, spill_path);
+
+        const int event_count = 20;
+        for (int i = 0; i < event_count; ++i) {
+            reporter.report(make_event(event_type::begin_item, i + 1, reportportal::gtest::null_handle, "item " + std::to_string(i)));
+        }
+
+        reportportal::gtest::reporter_metrics metrics;
+        reporter.collect(metrics);
+        REQUIRE(metrics.spilled >= event_count - 3);
+        REQUIRE(metrics.blocked == 0);
+        REQUIRE(reporter.pending() == event_count);
+
+        gated.open();
+        reporter.flush();
+
+        REQUIRE(gated.events.size() == event_count);
+        for (int i = 0; i < event_count; ++i) {
+            REQUIRE(gated.events[i].item == static_cast<reportportal::gtest::item_handle>(i + 1));
+            REQUIRE(gated.events[i].name == "item " + std::to_string(i));
+        }
+    }
+
+    // The spill file is gone once everything has been read back.
+    REQUIRE_FALSE(std::ifstream(spill_path).good());
+}
+
+TEST_CASE("Async reporter leaves an existing file at the spill path alone", "[async_reporter]")
+{
+    const std::string spill_path = "async_reporter_tests.spill";
+    std::ofstream(spill_path) << "not ours";
+
+    auto gate = std::make_unique<gated_reporter>();
+    gated_reporter& gated = *gate;
+
+    {
+        async_reporter reporter(std::move(gate), 1, 0, overflow_policy::spill, spill_path);
+        for (int i = 0; i < 5; ++i) {
+            reporter.report(make_event(event_type::begin_item, i + 1));
+        }
+        REQUIRE(std::ifstream(spill_path + ".1").good());
+
+        gated.open();
+        reporter.flush();
+        REQUIRE(gated.events.size() == 5);
+    }
+
+    std::string contents;
+    std::getline(std::ifstream(spill_path), contents);
+    REQUIRE(contents == "not ours");
+    REQUIRE_FALSE(std::ifstream(spill_path + ".1").good());
+
+    std::remove(spill_path.c_str());
+}
+
+TEST_CASE("Async reporter drops logs that do not fit", "[async_reporter]")
+{
+    auto gate = std::make_unique<gated_reporter>();
+    gated_reporter& gated = *gate;
+
+    // The budget fits a single event with a log at a time.
+    async_reporter reporter(std::move(gate), 16, 1500, overflow_policy::drop_logs);
+
+    reporter.report(make_event(event_type::begin_item, 1, reportportal::gtest::null_handle, "item"));
+    for (int i = 0; i < 10; ++i) {
+        reporter.report(make_log(1));
+    }
+
+    gated.open();
+
+    event completed = make_log(2);
+    completed.type = event_type::complete_item;
+    completed.item = 2;
+    reporter.report(completed);
+    reporter.report(make_event(event_type::end_item, 1));
+    reporter.flush();
+
+    reportportal::gtest::reporter_metrics metrics;
+    reporter.collect(metrics);
+    REQUIRE(metrics.dropped_logs > 0);
+
+    std::size_t delivered_logs = 0;
+    for (const event& e : gated.events) {
+        delivered_logs += e.logs.size();
+    }
+    REQUIRE(delivered_logs + metrics.dropped_logs == 11);
+
+    // Items and their ends are never dropped.
+    REQUIRE(gated.events.front().type == event_type::begin_item);
+    REQUIRE(gated.events.back().type == event_type::end_item);
+}
+
+TEST_CASE("Async reporter hands what is left over at a deadline", "[async_reporter]")
+{
+    auto gate = std::make_unique<gated_reporter>();
+    gated_reporter& gated = *gate;
+    async_reporter reporter(std::move(gate), 16);
+
+    const int event_count = 10;
+    for (int i = 0; i < event_count; ++i) {
+        reporter.report(make_event(event_type::begin_item, i + 1, reportportal::gtest::null_handle, "item " + std::to_string(i)));
+    }
+
+    REQUIRE_FALSE(reporter.flush_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(10)));
+    REQUIRE(reporter.pending() == event_count);
+
+    // The event held at the gate is delivered before the rest is handed over,
+    // and depending on timing a few more may be.
+    recording_reporter overflow;
+    std::thread opener([&gated] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        gated.open();
+    });
+    const uint64_t handed_over = reporter.abandon(overflow, std::chrono::steady_clock::now() + std::chrono::seconds(10));
+    opener.join();
+
+    REQUIRE(reporter.pending() == 0);
+    REQUIRE(handed_over == overflow.events.size());
+    REQUIRE(gated.events.size() >= 1);
+    REQUIRE(gated.events.size() + overflow.events.size() == event_count);
+
+    // Nothing is lost or reordered across the two.
+    std::vector<event> all = gated.events;
+    all.insert(all.end(), overflow.events.begin(), overflow.events.end());
+    for (int i = 0; i < event_count; ++i) {
+        REQUIRE(all[i].item == static_cast<reportportal::gtest::item_handle>(i + 1));
+    }
+
+    // The queue works as before afterwards.
+    reporter.report(make_event(event_type::end_item, 1));
+    REQUIRE(reporter.flush_until(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+    REQUIRE(gated.events.back().type == event_type::end_item);
+}
+
+TEST_CASE("Async reporter gives up on an event stuck past the deadline", "[async_reporter]")
+{
+    auto gate = std::make_unique<gated_reporter>();
+    gated_reporter& gated = *gate;
+    async_reporter reporter(std::move(gate), 16);
+
+    const int event_count = 10;
+    for (int i = 0; i < event_count; ++i) {
+        reporter.report(make_event(event_type::begin_item, i + 1, reportportal::gtest::null_handle, "item " + std::to_string(i)));
+    }
+
+    REQUIRE_FALSE(reporter.flush_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(10)));
+
+    // The first event never gets through the gate in time, the rest is
+    // handed over without it.
+    recording_reporter overflow;
+    const uint64_t handed_over = reporter.abandon(overflow, std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+    REQUIRE(handed_over == event_count - 1);
+    REQUIRE(overflow.events.size() == event_count - 1);
+    REQUIRE(overflow.events.front().item == 2);
+    REQUIRE(reporter.pending() == 1);
+
+    // Once through, the background thread carries on with new events.
+    reporter.report(make_event(event_type::end_item, 1));
+    gated.open();
+    reporter.flush();
+    REQUIRE(reporter.pending() == 0);
+    REQUIRE(gated.events.size() == 2);
+    REQUIRE(gated.events[0].item == 1);
+    REQUIRE(gated.events[1].type == event_type::end_item);
+}
+
+TEST_CASE("Async reporter construction", "[async_reporter]")
+{
+    REQUIRE_THROWS_AS(async_reporter(nullptr, 4), std::invalid_argument);
+    REQUIRE_THROWS_AS(async_reporter(std::make_unique<recording_reporter>(), 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        async_reporter(std::make_unique<recording_reporter>(), 4, 0, overflow_policy::spill),
+        std::invalid_argument);
+}
@@ -0,0 +1,411 @@
+#include <utils.h>
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <fakeit.hpp>
+#include <gtest/gtest.h>
+#include <reportportal/gtest/event_listener.hpp>
+#include <reportportal/gtest/log_ring.hpp>
+
+using namespace fakeit;
+using reportportal::gtest::event;
+using reportportal::gtest::event_listener;
+using reportportal::gtest::event_type;
+using reportportal::gtest::item_handle;
+using reportportal::gtest::listener_options;
+using reportportal::gtest::log_entry;
+
+namespace {
+
+const std::string metrics_path = "event_listener_tests.json";
+
+// A gtest test that runs the function it was registered with.
+class function_test : public ::testing::Test
+{
+    public:
+        explicit function_test(std::function<void()> body)
+          : _body(std::move(body))
+        {
+        }
+
+        void TestBody() override {
+            _body();
+        }
+
+    private:
+        std::function<void()> _body;
+};
+
+// Records every event but fails to deliver them when flushed, as a server
+// that went down at the end of the run would.
+class failing_flush_reporter : public recording_reporter
+{
+    public:
+        void flush() override {
+            throw std::runtime_error("server unavailable");
+        }
+};
+
+void register_test(const char* name, std::function<void()> body)
+{
+    ::testing::RegisterTest(
+        "ListenerTests", name, nullptr, nullptr, __FILE__, __LINE__,
+        [body]() -> ::testing::Test* { return new function_test(body); });
+}
+
+// Initializes gtest and registers the tests the listener watches, once for
+// all test cases.
+void initialize_gtest()
+{
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+
+    ::testing::InitGoogleTest();
+
+    // Leave the listener under test the only one reporting.
+    ::testing::TestEventListeners& listeners = ::testing::UnitTest::GetInstance()->listeners();
+    delete listeners.Release(listeners.default_result_printer());
+
+    register_test("Passes", [] {});
+    register_test("Fails", [] { ADD_FAILURE() << "broken"; });
+    register_test("Logs", [] {
+        reportportal::gtest::log(report_portal::log_level::info, "from the test");
+        std::thread([] { reportportal::gtest::log(report_portal::log_level::info, "from a thread"); }).join();
+    });
+    register_test("Prints", [] {
+        std::printf("printed\n");
+        ADD_FAILURE() << "after printing";
+    });
+    register_test("FailsAtLength", [] { ADD_FAILURE() << std::string(100, 'x'); });
+    initialized = true;
+}
+
+// Runs the registered tests matching filter, repeat times, with listener
+// attached. Returns what RUN_ALL_TESTS does.
+int run_tests(event_listener& listener, const std::string& filter, int repeat = 1)
+{
+    initialize_gtest();
+    ::testing::GTEST_FLAG(filter) = filter;
+    ::testing::GTEST_FLAG(repeat) = repeat;
+
+    ::testing::TestEventListeners& listeners = ::testing::UnitTest::GetInstance()->listeners();
+    listeners.Append(&listener);
+    const int result = RUN_ALL_TESTS();
+    listeners.Release(&listener);
+
+    ::testing::GTEST_FLAG(repeat) = 1;
+    return result;
+}
+
+// One line per event, followed by one per log entry naming the item it is
+// for, so whole sequences can be compared.
+std::vector<std::string> describe(const std::vector<event>& events)
+{
+    std::map<item_handle, std::string> names;
+    std::vector<std::string> lines;
+    for (const event& e : events) {
+        std::ostringstream line;
+        switch (e.type) {
+            case event_type::begin_launch:
+                line << "begin launch";
+                break;
+            case event_type::end_launch:
+                line << "end launch";
+                break;
+            case event_type::leave_launch:
+                line << "leave launch";
+                break;
+            case event_type::begin_item:
+                names[e.item] = e.name;
+                line << "begin " << e.name;
+                break;
+            case event_type::end_item:
+                line << "end " << names[e.item] << " " << e.status;
+                break;
+            case event_type::complete_item:
+                names[e.item] = e.name;
+                line << "complete " << e.name << " " << e.status;
+                break;
+            case event_type::log:
+                line << "log";
+                break;
+        }
+        lines.push_back(line.str());
+
+        for (const log_entry& entry : e.logs) {
+            lines.push_back("  to " + names[entry.item]);
+        }
+    }
+    return lines;
+}
+
+// The messages of every log entry, in the order they were reported.
+std::vector<std::string> messages(const std::vector<event>& events)
+{
+    std::vector<std::string> result;
+    for (const event& e : events) {
+        for (const log_entry& entry : e.logs) {
+            result.push_back(entry.message);
+        }
+    }
+    return result;
+}
+
+}
+
+TEST_CASE("Listener reports each test as it begins and ends", "[event_listener]")
+{
+    auto reporter = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *reporter;
+    event_listener listener(std::move(reporter));
+
+    REQUIRE(run_tests(listener, "ListenerTests.Passes:ListenerTests.Fails") == 1);
+
+    REQUIRE(describe(recorded.events) == std::vector<std::string>{
+        "begin launch",
+        "begin Google Test Suite",
+        "begin ListenerTests",
+        "begin Passes",
+        "end Passes passed",
+        "begin Fails",
+        "log",
+        "  to Fails",
+        "end Fails failed",
+        "end ListenerTests inherit",
+        "end Google Test Suite inherit",
+        "end launch"});
+    REQUIRE_THAT(messages(recorded.events)[0], Catch::EndsWith("\nFailed\nbroken"));
+    REQUIRE(recorded.flush_count == 1);
+}
+
+TEST_CASE("Listener reports deferred tests once they have ended", "[event_listener]")
+{
+    auto reporter = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *reporter;
+    listener_options options;
+    options.defer_tests = true;
+    event_listener listener(std::move(reporter), options);
+
+    REQUIRE(run_tests(listener, "ListenerTests.Passes:ListenerTests.Fails") == 1);
+
+    REQUIRE(describe(recorded.events) == std::vector<std::string>{
+        "begin launch",
+        "begin Google Test Suite",
+        "begin ListenerTests",
+        "complete Passes passed",
+        "complete Fails failed",
+        "  to Fails",
+        "end ListenerTests inherit",
+        "end Google Test Suite inherit",
+        "end launch"});
+    REQUIRE_THAT(messages(recorded.events)[0], Catch::EndsWith("\nFailed\nbroken"));
+}
+
+TEST_CASE("Listener summarizes passing tests in their suite", "[event_listener]")
+{
+    auto reporter = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *reporter;
+    listener_options options;
+    options.summarize_passes = true;
+    event_listener listener(std::move(reporter), options);
+
+    REQUIRE(run_tests(listener, "ListenerTests.Passes:ListenerTests.Fails:ListenerTests.Logs") == 1);
+
+    REQUIRE(describe(recorded.events) == std::vector<std::string>{
+        "begin launch",
+        "begin Google Test Suite",
+        "begin ListenerTests",
+        "complete Fails failed",
+        "  to Fails",
+        "log",
+        "  to ListenerTests",
+        "end ListenerTests failed",
+        "end Google Test Suite inherit",
+        "end launch"});
+
+    const std::vector<std::string> logged = messages(recorded.events);
+    REQUIRE(logged.size() == 2);
+    REQUIRE_THAT(logged[1], Catch::StartsWith("Passed tests: 2, "));
+    REQUIRE_THAT(logged[1], Catch::Contains("\nPasses\t"));
+    REQUIRE_THAT(logged[1], Catch::Contains("\nLogs\t"));
+}
+
+TEST_CASE("Listener reports repeated tests once for all iterations", "[event_listener]")
+{
+    auto reporter = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *reporter;
+    listener_options options;
+    options.aggregate_repeats = true;
+    event_listener listener(std::move(reporter), options);
+
+    REQUIRE(run_tests(listener, "ListenerTests.Passes:ListenerTests.Fails", 2) == 1);
+
+    REQUIRE(describe(recorded.events) == std::vector<std::string>{
+        "begin launch",
+        "begin Google Test Suite",
+        "begin ListenerTests",
+        "begin Passes",
+        "begin Fails",
+        "log",
+        "  to Fails",
+        "  to Fails",
+        "log",
+        "  to Fails",
+        "  to Fails",
+        "log",
+        "  to Passes",
+        "end Passes passed",
+        "log",
+        "  to Fails",
+        "end Fails failed",
+        "end ListenerTests inherit",
+        "end Google Test Suite inherit",
+        "end launch"});
+
+    const std::vector<std::string> logged = messages(recorded.events);
+    REQUIRE(logged.size() == 6);
+    REQUIRE(logged[0] == "Iteration 1");
+    REQUIRE_THAT(logged[1], Catch::EndsWith("\nFailed\nbroken"));
+    REQUIRE(logged[2] == "Iteration 2");
+    REQUIRE_THAT(logged[3], Catch::EndsWith("\nFailed\nbroken"));
+    REQUIRE_THAT(logged[4], Catch::StartsWith("Ran 2 times: 2 passed, 0 failed, 0 skipped\n"));
+    REQUIRE_THAT(logged[5], Catch::StartsWith("Ran 2 times: 0 passed, 2 failed, 0 skipped\n"));
+}
+
+TEST_CASE("Listener reports what tests log to the running test", "[event_listener]")
+{
+    auto reporter = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *reporter;
+    listener_options options;
+    std::vector<std::string> expected;
+
+    SECTION("as it ends") {
+        expected = {
+            "begin launch",
+            "begin Google Test Suite",
+            "begin ListenerTests",
+            "begin Logs",
+            "log",
+            "  to Logs",
+            "  to Logs",
+            "end Logs passed",
+            "end ListenerTests inherit",
+            "end Google Test Suite inherit",
+            "end launch"};
+    }
+
+    SECTION("with a deferred test") {
+        options.defer_tests = true;
+        expected = {
+            "begin launch",
+            "begin Google Test Suite",
+            "begin ListenerTests",
+            "complete Logs passed",
+            "  to Logs",
+            "  to Logs",
+            "end ListenerTests inherit",
+            "end Google Test Suite inherit",
+            "end launch"};
+    }
+
+    event_listener listener(std::move(reporter), options);
+    REQUIRE(run_tests(listener, "ListenerTests.Logs") == 0);
+
+    REQUIRE(describe(recorded.events) == expected);
+    REQUIRE(messages(recorded.events) == std::vector<std::string>{"from the test", "from a thread"});
+}
+
+#ifndef _WIN32
+TEST_CASE("Listener logs the output of failed tests", "[event_listener]")
+{
+    auto reporter = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *reporter;
+    listener_options options;
+    options.capture_output = true;
+    event_listener listener(std::move(reporter), options);
+
+    REQUIRE(run_tests(listener, "ListenerTests.Passes:ListenerTests.Prints") == 1);
+
+    REQUIRE(describe(recorded.events) == std::vector<std::string>{
+        "begin launch",
+        "begin Google Test Suite",
+        "begin ListenerTests",
+        "begin Passes",
+        "end Passes passed",
+        "begin Prints",
+        "log",
+        "  to Prints",
+        "log",
+        "  to Prints",
+        "end Prints failed",
+        "end ListenerTests inherit",
+        "end Google Test Suite inherit",
+        "end launch"});
+
+    const std::vector<std::string> logged = messages(recorded.events);
+    REQUIRE_THAT(logged[0], Catch::EndsWith("\nFailed\nafter printing"));
+    REQUIRE(logged[1] == "Output of the test, 8 bytes:\nprinted\n");
+}
+#endif
+
+TEST_CASE("Listener cuts long failure messages", "[event_listener]")
+{
+    auto reporter = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *reporter;
+    listener_options options;
+    options.log_message_limit = 16;
+    event_listener listener(std::move(reporter), options);
+
+    REQUIRE(run_tests(listener, "ListenerTests.FailsAtLength") == 1);
+
+    const std::vector<std::string> logged = messages(recorded.events);
+    REQUIRE(logged.size() == 1);
+    REQUIRE_THAT(logged[0], Catch::StartsWith("file = "));
+    REQUIRE_THAT(logged[0], Catch::EndsWith("\nFailed\nxxxxxxxxx\n... 91 more bytes left out"));
+}
+
+TEST_CASE("Listener exports its metrics when the final flush fails", "[event_listener]")
+{
+    std::remove(metrics_path.c_str());
+
+    auto reporter = std::make_unique<failing_flush_reporter>();
+    recording_reporter& recorded = *reporter;
+    listener_options options;
+    options.metrics_path = metrics_path;
+    event_listener listener(std::move(reporter), options);
+
+    // gtest turns the exception thrown by the listener into a failure.
+    REQUIRE(run_tests(listener, "ListenerTests.Passes") == 1);
+    REQUIRE(describe(recorded.events).back() == "end launch");
+
+    std::ifstream input(metrics_path);
+    REQUIRE(input);
+    const std::string json((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    REQUIRE_THAT(json, Catch::StartsWith("{"));
+
+    input.close();
+    std::remove(metrics_path.c_str());
+}
+
+TEST_CASE("Listener borrowing the service rejects a flush deadline", "[event_listener]")
+{
+    Mock<report_portal::iservice> service_mock;
+    listener_options options;
+    options.asynchronous = true;
+    options.flush_deadline = std::chrono::seconds(1);
+
+    REQUIRE_THROWS_AS(event_listener(service_mock.get(), options), std::invalid_argument);
+}
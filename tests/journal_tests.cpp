@@ -0,0 +1,233 @@
+#include <utils.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include <catch2/catch.hpp>
+#include <fakeit.hpp>
+#include <reportportal/gtest/journal.hpp>
+#include <reportportal/gtest/service_reporter.hpp>
+
+using namespace fakeit;
+using reportportal::gtest::event;
+using reportportal::gtest::event_type;
+using reportportal::gtest::log_entry;
+
+namespace {
+
+const std::string journal_path = "journal_tests.rpj";
+
+std::vector<event> make_events()
+{
+    std::vector<event> events(5);
+
+    events[0].type = event_type::begin_launch;
+    events[0].item = 1;
+    events[0].time = from_iso_8601("2020-05-09T22:30:58-0500");
+    events[0].name = "Test Launch";
+    events[0].description = "Launch description";
+    events[0].rerun_of = uuids::uuid::from_string("0f7a7e3c-58e4-4b7a-9a3e-4d4c2a1e5b6f");
+
+    events[1].type = event_type::begin_item;
+    events[1].item = 2;
+    events[1].parent = 1;
+    events[1].time = from_iso_8601("2020-05-09T22:31:58-0500") + std::chrono::microseconds(123456);
+    events[1].name = "Test Suite";
+    events[1].item_type = report_portal::test_item_type::step;
+
+    log_entry entry;
+    entry.item = 2;
+    entry.time = from_iso_8601("2020-05-09T22:32:58-0500");
+    entry.level = report_portal::log_level::warn;
+    entry.message = std::string(300, 'x');
+    events[2].type = event_type::log;
+    events[2].logs.push_back(entry);
+
+    events[3].type = event_type::end_item;
+    events[3].item = 2;
+    events[3].time = from_iso_8601("2020-05-09T22:33:58-0500");
+    events[3].status = report_portal::test_item_status::failed;
+
+    events[4].type = event_type::complete_item;
+    events[4].item = 3;
+    events[4].parent = 1;
+    events[4].time = from_iso_8601("2020-05-09T22:34:58-0500");
+    events[4].end_time = from_iso_8601("2020-05-09T22:35:58-0500");
+    events[4].name = "Test";
+    events[4].item_type = report_portal::test_item_type::step;
+    events[4].status = report_portal::test_item_status::passed;
+    entry.item = 3;
+    events[4].logs.push_back(entry);
+
+    return events;
+}
+
+}
+
+TEST_CASE("Journal round trip", "[journal]")
+{
+    std::remove(journal_path.c_str());
+    const std::vector<event> events = make_events();
+    {
+        reportportal::gtest::journal_writer writer(journal_path);
+        for (const event& e : events) {
+            writer.report(e);
+        }
+    }
+
+    SECTION("replays every event") {
+        recording_reporter recorded;
+        REQUIRE(reportportal::gtest::replay_journal(journal_path, recorded) == events.size());
+        REQUIRE(recorded.flush_count == 1);
+        REQUIRE(recorded.events.size() == events.size());
+
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const event& expected = events[i];
+            const event& actual = recorded.events[i];
+            REQUIRE(actual.type == expected.type);
+            REQUIRE(actual.item == expected.item);
+            REQUIRE(actual.parent == expected.parent);
+            REQUIRE(actual.time == expected.time);
+            REQUIRE(actual.end_time == expected.end_time);
+            REQUIRE(actual.name == expected.name);
+            REQUIRE(actual.description == expected.description);
+            REQUIRE(actual.item_type == expected.item_type);
+            REQUIRE(actual.status == expected.status);
+            REQUIRE(actual.rerun_of == expected.rerun_of);
+            REQUIRE(actual.logs.size() == expected.logs.size());
+            for (std::size_t j = 0; j < expected.logs.size(); ++j) {
+                REQUIRE(actual.logs[j].item == expected.logs[j].item);
+                REQUIRE(actual.logs[j].time == expected.logs[j].time);
+                REQUIRE(actual.logs[j].level == expected.logs[j].level);
+                REQUIRE(actual.logs[j].message == expected.logs[j].message);
+            }
+        }
+    }
+
+    SECTION("appending keeps earlier events") {
+        {
+            reportportal::gtest::journal_writer writer(journal_path);
+            writer.report(events[0]);
+        }
+
+        recording_reporter recorded;
+        REQUIRE(reportportal::gtest::replay_journal(journal_path, recorded) == events.size() + 1);
+    }
+
+    SECTION("a truncated record ends the journal") {
+        std::ifstream input(journal_path, std::ios::binary);
+        const std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        input.close();
+
+        std::ofstream output(journal_path, std::ios::binary | std::ios::trunc);
+        output.write(contents.data(), contents.size() - 5);
+        output.close();
+
+        recording_reporter recorded;
+        REQUIRE(reportportal::gtest::replay_journal(journal_path, recorded) == events.size() - 1);
+    }
+
+    std::remove(journal_path.c_str());
+}
+
+TEST_CASE("Journal rejects other files", "[journal]")
+{
+    {
+        std::ofstream output(journal_path, std::ios::binary | std::ios::trunc);
+        output << "not a journal";
+    }
+
+    REQUIRE_THROWS_AS(reportportal::gtest::journal_reader(journal_path), std::runtime_error);
+    REQUIRE_THROWS_AS(reportportal::gtest::journal_writer(journal_path), std::runtime_error);
+    std::remove(journal_path.c_str());
+
+    REQUIRE_THROWS_AS(reportportal::gtest::journal_reader(journal_path), std::runtime_error);
+
+    SECTION("of another version") {
+        {
+            std::ofstream output(journal_path, std::ios::binary | std::ios::trunc);
+            output << "RPGTJRNL" << '\x02';
+        }
+
+        REQUIRE_THROWS_AS(reportportal::gtest::journal_writer(journal_path), std::runtime_error);
+    }
+
+    SECTION("with an implausibly long record") {
+        {
+            std::ofstream output(journal_path, std::ios::binary | std::ios::trunc);
+            output << "RPGTJRNL" << '\x03' << "\xff\xff\xff\xff\xff\xff\xff\x7f";
+        }
+
+        reportportal::gtest::journal_reader reader(journal_path);
+        event e;
+        REQUIRE_THROWS_AS(reader.next(e), std::runtime_error);
+    }
+
+    SECTION("with an unknown event") {
+        {
+            std::ofstream output(journal_path, std::ios::binary | std::ios::trunc);
+            output << "RPGTJRNL" << '\x03' << '\x01' << '\x42';
+        }
+
+        reportportal::gtest::journal_reader reader(journal_path);
+        event e;
+        REQUIRE_THROWS_AS(reader.next(e), std::runtime_error);
+    }
+
+    std::remove(journal_path.c_str());
+}
+
+TEST_CASE("Journal finds an unused path", "[journal]")
+{
+    REQUIRE(reportportal::gtest::unused_path(journal_path) == journal_path);
+
+    std::ofstream(journal_path) << "taken";
+    REQUIRE(reportportal::gtest::unused_path(journal_path) == journal_path + ".1");
+
+    std::ofstream(journal_path + ".1") << "taken";
+    REQUIRE(reportportal::gtest::unused_path(journal_path) == journal_path + ".2");
+
+    std::remove((journal_path + ".1").c_str());
+    std::remove(journal_path.c_str());
+}
+
+TEST_CASE("Journal replays into a service", "[journal]")
+{
+    std::remove(journal_path.c_str());
+    {
+        reportportal::gtest::journal_writer writer(journal_path);
+        writer.report(make_events()[0]);
+    }
+
+    Mock<report_portal::iservice> service_mock;
+    reportportal::gtest::service_reporter reporter(service_mock.get());
+
+    uuids::uuid generated_launch_id = uuids::uuid::from_string("47183823-2574-4bfd-b411-99ed177d3e43");
+    When(Method(service_mock, begin_launch)
+        .Using(
+            _,
+            _,
+            _,
+            _,
+            _,
+            _,
+            _,
+            _))
+        .Return(report_portal::begin_launch_responce(generated_launch_id));
+
+    REQUIRE(reportportal::gtest::replay_journal(journal_path, reporter) == 1);
+
+    Verify(Method(service_mock, begin_launch)
+        .Using(
+            "Test Launch",
+            from_iso_8601("2020-05-09T22:30:58-0500"),
+            "Launch description",
+            make_events()[0].rerun_of,
+            _,
+            _,
+            _,
+            _))
+        .Exactly(1);
+
+    std::remove(journal_path.c_str());
+}
@@ -0,0 +1,77 @@
+#include <utils.h>
+
+#include <sstream>
+
+#include <catch2/catch.hpp>
+#include <reportportal/gtest/async_reporter.hpp>
+#include <reportportal/gtest/listener_metrics.hpp>
+
+using reportportal::gtest::latency_histogram;
+using reportportal::gtest::listener_hook;
+using reportportal::gtest::listener_metrics;
+using reportportal::gtest::reporter_metrics;
+
+TEST_CASE("Latency histogram", "[listener_metrics]")
+{
+    latency_histogram histogram;
+    REQUIRE(histogram.count() == 0);
+    REQUIRE(histogram.percentile(0.5) == std::chrono::nanoseconds::zero());
+
+    for (int i = 0; i < 99; ++i) {
+        histogram.record(std::chrono::nanoseconds(100));
+    }
+    histogram.record(std::chrono::microseconds(50));
+
+    REQUIRE(histogram.count() == 100);
+    REQUIRE(histogram.total() == std::chrono::nanoseconds(99 * 100 + 50000));
+    REQUIRE(histogram.max() == std::chrono::microseconds(50));
+
+    // 100ns falls into the bucket of 64 to 127ns.
+    REQUIRE(histogram.buckets()[7] == 99);
+    REQUIRE(histogram.percentile(0.5) == std::chrono::nanoseconds(127));
+    REQUIRE(histogram.percentile(0.99) == std::chrono::nanoseconds(127));
+    REQUIRE(histogram.percentile(1.0) == std::chrono::microseconds(50));
+}
+
+TEST_CASE("Listener metrics export", "[listener_metrics]")
+{
+    listener_metrics metrics;
+    metrics.hook(listener_hook::test_start).record(std::chrono::nanoseconds(200));
+    metrics.events = 3;
+    metrics.reporter.requests = 2;
+    metrics.reporter.dropped_logs = 4;
+
+    SECTION("json") {
+        std::ostringstream out;
+        metrics.write_json(out);
+
+        const std::string json = out.str();
+        REQUIRE(json.front() == '{');
+        REQUIRE(json.back() == '}');
+        REQUIRE(json.find("\"test_start\":{\"count\":1,\"total_ns\":200,\"max_ns\":200") != std::string::npos);
+        REQUIRE(json.find("\"events\":3") != std::string::npos);
+        REQUIRE(json.find("\"requests\":2") != std::string::npos);
+        REQUIRE(json.find("\"dropped_logs\":4") != std::string::npos);
+    }
+
+    SECTION("text") {
+        std::ostringstream out;
+        metrics.write_text(out);
+
+        const std::string text = out.str();
+        REQUIRE(text.find("test_start: count 1") != std::string::npos);
+        REQUIRE(text.find("test_end") == std::string::npos);
+    }
+}
+
+TEST_CASE("Async reporter collects its queue depth", "[listener_metrics]")
+{
+    reportportal::gtest::async_reporter reporter(std::make_unique<recording_reporter>(), 8);
+    reporter.report(reportportal::gtest::event());
+    reporter.flush();
+
+    reporter_metrics metrics;
+    reporter.collect(metrics);
+    REQUIRE(metrics.queued == 0);
+    REQUIRE(metrics.max_queued == 1);
+}
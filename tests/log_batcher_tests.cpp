@@ -0,0 +1,153 @@
+#include <utils.h>
+
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <reportportal/gtest/log_batcher.hpp>
+
+using reportportal::gtest::event;
+using reportportal::gtest::event_type;
+using reportportal::gtest::item_handle;
+using reportportal::gtest::log_batcher;
+using reportportal::gtest::log_entry;
+
+namespace {
+
+std::chrono::system_clock::time_point stamp(int second)
+{
+    return std::chrono::system_clock::time_point(std::chrono::seconds(second));
+}
+
+event make_log(item_handle item, report_portal::log_level level, const std::string& message, int second = 0)
+{
+    log_entry entry;
+    entry.item = item;
+    entry.level = level;
+    entry.time = stamp(second);
+    entry.message = message;
+
+    event e;
+    e.type = event_type::log;
+    e.logs.push_back(entry);
+    return e;
+}
+
+event make_end(item_handle item)
+{
+    event e;
+    e.type = event_type::end_item;
+    e.item = item;
+    return e;
+}
+
+}
+
+TEST_CASE("Log batcher holds logs until the item ends", "[log_batcher]")
+{
+    auto recorder = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *recorder;
+    log_batcher batcher(std::move(recorder), 100, 1024 * 1024, std::chrono::hours(1));
+
+    batcher.report(make_log(3, report_portal::log_level::error, "first", 1));
+    batcher.report(make_log(3, report_portal::log_level::error, "second", 2));
+    batcher.report(make_log(3, report_portal::log_level::warn, "third", 3));
+
+    REQUIRE(recorded.events.empty());
+    REQUIRE(batcher.pending() == 3);
+
+    SECTION("ending another item does not send the batch") {
+        batcher.report(make_end(4));
+
+        REQUIRE(recorded.events.size() == 1);
+        REQUIRE(batcher.pending() == 3);
+    }
+
+    SECTION("ending the item sends one batch first") {
+        batcher.report(make_end(3));
+
+        REQUIRE(batcher.pending() == 0);
+        REQUIRE(recorded.events.size() == 2);
+
+        // The entries keep their own level and time.
+        const event& batch = recorded.events[0];
+        REQUIRE(batch.type == event_type::log);
+        REQUIRE(batch.logs.size() == 3);
+        REQUIRE(batch.logs[0].message == "first");
+        REQUIRE(batch.logs[0].level == report_portal::log_level::error);
+        REQUIRE(batch.logs[0].time == stamp(1));
+        REQUIRE(batch.logs[1].message == "second");
+        REQUIRE(batch.logs[1].time == stamp(2));
+        REQUIRE(batch.logs[2].message == "third");
+        REQUIRE(batch.logs[2].level == report_portal::log_level::warn);
+        REQUIRE(batch.logs[2].time == stamp(3));
+
+        REQUIRE(recorded.events[1].type == event_type::end_item);
+    }
+
+    SECTION("leaving the launch sends the batch first") {
+        event leave;
+        leave.type = event_type::leave_launch;
+        leave.item = 1;
+        batcher.report(leave);
+
+        REQUIRE(batcher.pending() == 0);
+        REQUIRE(recorded.events.size() == 2);
+        REQUIRE(recorded.events[0].type == event_type::log);
+        REQUIRE(recorded.events[1].type == event_type::leave_launch);
+    }
+
+    SECTION("flushing sends the batch") {
+        batcher.flush();
+
+        REQUIRE(batcher.pending() == 0);
+        REQUIRE(recorded.events.size() == 1);
+        REQUIRE(recorded.flush_count == 1);
+    }
+}
+
+TEST_CASE("Log batcher thresholds", "[log_batcher]")
+{
+    auto recorder = std::make_unique<recording_reporter>();
+    recording_reporter& recorded = *recorder;
+
+    SECTION("entry count") {
+        log_batcher batcher(std::move(recorder), 2, 1024 * 1024, std::chrono::hours(1));
+        batcher.report(make_log(3, report_portal::log_level::error, "first"));
+        REQUIRE(recorded.events.empty());
+
+        batcher.report(make_log(5, report_portal::log_level::error, "second"));
+        REQUIRE(recorded.events.size() == 1);
+        REQUIRE(recorded.events[0].logs.size() == 2);
+    }
+
+    SECTION("message bytes") {
+        log_batcher batcher(std::move(recorder), 100, 8, std::chrono::hours(1));
+        batcher.report(make_log(3, report_portal::log_level::error, "1234"));
+        REQUIRE(recorded.events.empty());
+
+        batcher.report(make_log(3, report_portal::log_level::error, "5678"));
+        REQUIRE(recorded.events.size() == 1);
+    }
+
+    SECTION("delay") {
+        log_batcher batcher(std::move(recorder), 100, 1024 * 1024, std::chrono::milliseconds(0));
+        batcher.report(make_log(3, report_portal::log_level::error, "first"));
+        REQUIRE(recorded.events.size() == 1);
+    }
+
+    SECTION("delay with nothing else reported") {
+        log_batcher batcher(std::move(recorder), 100, 1024 * 1024, std::chrono::milliseconds(10));
+        batcher.report(make_log(3, report_portal::log_level::error, "first"));
+
+        const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (batcher.pending() > 0 && std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(batcher.pending() == 0);
+
+        // Waits for the timer to be done with the batch.
+        batcher.flush();
+        REQUIRE(recorded.events.size() == 1);
+        REQUIRE(recorded.events[0].logs.size() == 1);
+    }
+}
@@ -0,0 +1,126 @@
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+#include <reportportal/gtest/log_ring.hpp>
+
+using reportportal::gtest::log_entry;
+using reportportal::gtest::log_ring;
+
+TEST_CASE("Log ring hands entries over in order", "[log_ring]")
+{
+    log_ring ring(3);
+    REQUIRE(ring.capacity() == 4);
+
+    log_entry entry;
+    REQUIRE_FALSE(ring.pop(entry));
+
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(ring.push(report_portal::log_level::info, "entry " + std::to_string(i)));
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(ring.pop(entry));
+            REQUIRE(entry.level == report_portal::log_level::info);
+            REQUIRE(entry.message == "entry " + std::to_string(i));
+        }
+        REQUIRE_FALSE(ring.pop(entry));
+    }
+
+    SECTION("a full ring drops entries") {
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(ring.push(report_portal::log_level::info, "kept"));
+        }
+        REQUIRE_FALSE(ring.push(report_portal::log_level::info, "dropped"));
+        REQUIRE(ring.dropped() == 1);
+
+        REQUIRE(ring.pop(entry));
+        REQUIRE(ring.push(report_portal::log_level::info, "kept"));
+    }
+}
+
+TEST_CASE("Log ring takes entries from several threads at once", "[log_ring]")
+{
+    const int thread_count = 4;
+    const int entries_per_thread = 10000;
+    log_ring ring(256);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < thread_count; ++t) {
+        producers.emplace_back([&ring, t] {
+            for (int i = 0; i < entries_per_thread; ++i) {
+                const std::string message = std::to_string(t) + " " + std::to_string(i);
+                while (!ring.push(report_portal::log_level::debug, message)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each thread's entries arrive in the order it pushed them.
+    std::vector<int> next(thread_count, 0);
+    log_entry entry;
+    int received = 0;
+    while (received < thread_count * entries_per_thread) {
+        if (!ring.pop(entry)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const std::size_t space = entry.message.find(' ');
+        const int t = std::stoi(entry.message.substr(0, space));
+        const int i = std::stoi(entry.message.substr(space + 1));
+        REQUIRE(i == next[t]);
+        ++next[t];
+        ++received;
+    }
+
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    REQUIRE_FALSE(ring.pop(entry));
+}
+
+TEST_CASE("Logging goes to the installed ring", "[log_ring]")
+{
+    REQUIRE_FALSE(reportportal::gtest::log(report_portal::log_level::info, "nobody listens"));
+
+    log_entry entry;
+    {
+        log_ring ring(8);
+        reportportal::gtest::set_log_ring(&ring);
+        REQUIRE(reportportal::gtest::log(report_portal::log_level::warn, "from a test"));
+        REQUIRE(ring.pop(entry));
+        REQUIRE(entry.message == "from a test");
+    }
+
+    // A ring takes itself out when it goes away.
+    REQUIRE_FALSE(reportportal::gtest::log(report_portal::log_level::info, "nobody listens"));
+}
+
+TEST_CASE("Logging to a full ring drops the entry", "[log_ring]")
+{
+    log_ring ring(2);
+    reportportal::gtest::set_log_ring(&ring);
+
+    REQUIRE(reportportal::gtest::log(report_portal::log_level::info, "0"));
+    REQUIRE(reportportal::gtest::log(report_portal::log_level::info, "1"));
+    REQUIRE_FALSE(reportportal::gtest::log(report_portal::log_level::info, "2"));
+    REQUIRE(ring.dropped() == 1);
+
+    log_entry entry;
+    REQUIRE(ring.pop(entry));
+    REQUIRE(entry.message == "0");
+    REQUIRE(reportportal::gtest::log(report_portal::log_level::info, "3"));
+
+    ring.uninstall();
+    REQUIRE_FALSE(reportportal::gtest::log(report_portal::log_level::info, "nobody listens"));
+}
+
+TEST_CASE("Log ring construction", "[log_ring]")
+{
+    REQUIRE_THROWS_AS(log_ring(0), std::invalid_argument);
+}
@@ -0,0 +1,84 @@
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+#include <reportportal/gtest/object_pool.hpp>
+
+namespace {
+
+class tracked
+{
+    public:
+        explicit tracked(int& alive, bool fail = false)
+          : _alive(alive)
+        {
+            if (fail) {
+                throw std::runtime_error("construction failed");
+            }
+            ++_alive;
+        }
+
+        ~tracked() {
+            --_alive;
+        }
+
+    private:
+        int& _alive;
+};
+
+}
+
+TEST_CASE("Object pool recycles storage", "[object_pool]")
+{
+    int alive = 0;
+    reportportal::gtest::object_pool<tracked> pool(2);
+
+    REQUIRE(pool.size() == 0);
+    REQUIRE(pool.capacity() == 0);
+
+    tracked* first = pool.create(alive);
+    tracked* second = pool.create(alive);
+    REQUIRE(alive == 2);
+    REQUIRE(pool.size() == 2);
+    REQUIRE(pool.capacity() == 2);
+
+    SECTION("destroyed slots are handed out again") {
+        pool.destroy(first);
+        REQUIRE(alive == 1);
+        REQUIRE(pool.size() == 1);
+
+        tracked* third = pool.create(alive);
+        REQUIRE(third == first);
+        REQUIRE(pool.capacity() == 2);
+
+        pool.destroy(third);
+    }
+
+    SECTION("the pool grows by whole blocks") {
+        tracked* third = pool.create(alive);
+        REQUIRE(pool.capacity() == 4);
+
+        pool.destroy(third);
+        pool.destroy(first);
+    }
+
+    SECTION("a failing constructor gives its slot back") {
+        pool.destroy(first);
+        REQUIRE_THROWS_AS(pool.create(alive, true), std::runtime_error);
+        REQUIRE(pool.size() == 1);
+
+        tracked* third = pool.create(alive);
+        REQUIRE(third == first);
+        REQUIRE(pool.capacity() == 2);
+
+        pool.destroy(third);
+    }
+
+    pool.destroy(second);
+    REQUIRE(alive == 0);
+    REQUIRE(pool.size() == 0);
+}
+
+TEST_CASE("Object pool construction", "[object_pool]")
+{
+    REQUIRE_THROWS_AS(reportportal::gtest::object_pool<int>(0), std::invalid_argument);
+}
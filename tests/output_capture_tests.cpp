@@ -0,0 +1,86 @@
+#ifndef _WIN32
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include <catch2/catch.hpp>
+#include <reportportal/gtest/output_capture.hpp>
+
+using reportportal::gtest::output_capture;
+
+TEST_CASE("Output capture keeps what stdout and stderr are given", "[output_capture]")
+{
+    output_capture capture(64, 64);
+    std::string text;
+
+    std::printf("to stdout\n");
+    ::write(2, "to stderr\n", 10);
+    REQUIRE(std::system("echo from a child") == 0);
+
+    REQUIRE(capture.take(text) == 33);
+    REQUIRE(text.find("to stdout\n") != std::string::npos);
+    REQUIRE(text.find("to stderr\n") != std::string::npos);
+    REQUIRE(text.find("from a child\n") != std::string::npos);
+
+    SECTION("restarting forgets the earlier output") {
+        capture.restart();
+        std::printf("again\n");
+
+        REQUIRE(capture.take(text) == 6);
+        REQUIRE(text == "again\n");
+    }
+}
+
+TEST_CASE("Output capture keeps the beginning and the end", "[output_capture]")
+{
+    output_capture capture(4, 6);
+    std::string text;
+
+    SECTION("short output is kept whole") {
+        std::printf("0123456789");
+        REQUIRE(capture.take(text) == 10);
+        REQUIRE(text == "0123456789");
+    }
+
+    SECTION("the middle of long output is skipped") {
+        std::printf("head");
+        for (int i = 0; i < 100; ++i) {
+            std::printf("%d", i % 10);
+            std::fflush(stdout);
+        }
+        std::printf("tail!\n");
+
+        REQUIRE(capture.take(text) == 110);
+        REQUIRE(text == "head\n[... 100 bytes skipped ...]\ntail!\n");
+    }
+}
+
+TEST_CASE("Output capture does not wait for a thread that keeps writing", "[output_capture]")
+{
+    output_capture capture(16, 16);
+    std::string text;
+
+    std::atomic<bool> stop{false};
+    std::thread writer([&stop] {
+        while (!stop) {
+            ::write(1, ".", 1);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    std::printf("before");
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE(capture.take(text) >= 6);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+
+    stop = true;
+    writer.join();
+}
+
+#endif
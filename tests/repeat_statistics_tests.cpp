@@ -0,0 +1,72 @@
+#include <string>
+
+#include <catch2/catch.hpp>
+#include <reportportal/gtest/repeat_statistics.hpp>
+
+using reportportal::gtest::repeat_statistics;
+
+TEST_CASE("Repeat statistics", "[repeat_statistics]")
+{
+    repeat_statistics statistics;
+    REQUIRE(statistics.runs() == 0);
+    REQUIRE(statistics.mean() == std::chrono::milliseconds::zero());
+    REQUIRE(statistics.status() == report_portal::test_item_status::skipped);
+
+    SECTION("counts outcomes and durations")
+    {
+        for (int i = 0; i < 99; ++i) {
+            statistics.record(report_portal::test_item_status::passed, std::chrono::milliseconds(10));
+        }
+        statistics.record(report_portal::test_item_status::skipped, std::chrono::milliseconds(0));
+        statistics.record(report_portal::test_item_status::failed, std::chrono::milliseconds(200));
+
+        REQUIRE(statistics.runs() == 101);
+        REQUIRE(statistics.passed() == 99);
+        REQUIRE(statistics.failed() == 1);
+        REQUIRE(statistics.skipped() == 1);
+        REQUIRE(statistics.status() == report_portal::test_item_status::failed);
+
+        // The skipped iteration has no part in the durations.
+        REQUIRE(statistics.min() == std::chrono::milliseconds(10));
+        REQUIRE(statistics.mean() == std::chrono::milliseconds(11));
+        REQUIRE(statistics.max() == std::chrono::milliseconds(200));
+
+        REQUIRE(statistics.percentile(0.5) == std::chrono::milliseconds(10));
+        REQUIRE(statistics.percentile(0.99) == std::chrono::milliseconds(10));
+        REQUIRE(statistics.percentile(1.0) == std::chrono::milliseconds(200));
+
+        std::string description;
+        statistics.describe(description);
+        REQUIRE(description == "Ran 101 times: 99 passed, 1 failed, 1 skipped\n"
+                               "duration min 10 ms, mean 11 ms, p99 10 ms, max 200 ms");
+    }
+
+    SECTION("keeps durations exact")
+    {
+        for (int i = 1; i <= 100; ++i) {
+            statistics.record(report_portal::test_item_status::passed, std::chrono::milliseconds(i));
+        }
+
+        REQUIRE(statistics.percentile(0.0) == std::chrono::milliseconds(1));
+        REQUIRE(statistics.percentile(0.9) == std::chrono::milliseconds(90));
+        REQUIRE(statistics.percentile(0.99) == std::chrono::milliseconds(99));
+    }
+
+    SECTION("passes when no iteration failed")
+    {
+        statistics.record(report_portal::test_item_status::skipped, std::chrono::milliseconds(3));
+        statistics.record(report_portal::test_item_status::passed, std::chrono::milliseconds(5));
+
+        REQUIRE(statistics.status() == report_portal::test_item_status::passed);
+        REQUIRE(statistics.min() == std::chrono::milliseconds(5));
+    }
+
+    SECTION("has no durations when every iteration was skipped")
+    {
+        statistics.record(report_portal::test_item_status::skipped, std::chrono::milliseconds(3));
+
+        REQUIRE(statistics.runs() == 1);
+        REQUIRE(statistics.min() == std::chrono::milliseconds::zero());
+        REQUIRE(statistics.percentile(0.99) == std::chrono::milliseconds::zero());
+    }
+}
@@ -0,0 +1,180 @@
+#include <utils.h>
+
+#include <catch2/catch.hpp>
+#include <reportportal/rapidjson_serializer.hpp>
+
+#include <json_writer.hpp>
+#include <request_schema.hpp>
+#include <request_serializer.hpp>
+
+using reportportal::gtest::json_writer;
+using reportportal::gtest::request_serializer;
+
+TEST_CASE("Json writer", "[json_writer]")
+{
+    std::string out = "kept";
+    json_writer writer(out);
+
+    writer.begin_object();
+    writer.key("text");
+    writer.value("quote \" backslash \\ newline \n tab \t bell \x07 \xc3\xa9");
+    writer.key("numbers");
+    writer.begin_array();
+    writer.value(uint64_t(0));
+    writer.value(uint64_t(18446744073709551615ull));
+    writer.begin_object();
+    writer.end_object();
+    writer.begin_array();
+    writer.end_array();
+    writer.end_array();
+    writer.key("flag");
+    writer.value(false);
+    writer.end_object();
+
+    REQUIRE(out ==
+        "kept{"
+        "\"text\":\"quote \\\" backslash \\\\ newline \\n tab \\t bell \\u0007 \xc3\xa9\","
+        "\"numbers\":[0,18446744073709551615,{},[]],"
+        "\"flag\":false"
+        "}");
+}
+
+TEST_CASE("Json writer timestamps", "[json_writer]")
+{
+    const std::chrono::system_clock::time_point time = from_iso_8601("2020-05-09T22:30:58-0500");
+
+    std::string whole;
+    reportportal::gtest::append_timestamp(whole, time);
+    std::string fraction;
+    reportportal::gtest::append_timestamp(fraction, time + std::chrono::microseconds(1234));
+
+    REQUIRE(whole.size() == fraction.size());
+    REQUIRE(whole.substr(0, 20) == fraction.substr(0, 20));
+    REQUIRE(whole.substr(19, 7) == ".000000");
+    REQUIRE(fraction.substr(19, 7) == ".001234");
+    REQUIRE(whole.substr(26) == fraction.substr(26));
+}
+
+// Both serializers have to produce exactly the same requests.
+TEST_CASE("Request serializer matches the rapidjson serializer", "[request_serializer]")
+{
+    report_portal::rapidjson_serializer serializer;
+    request_serializer fast;
+    std::string body = "previous contents";
+
+    const std::chrono::system_clock::time_point time = from_iso_8601("2020-05-09T22:30:58-0500") + std::chrono::microseconds(250);
+    const uuids::uuid launch_id = uuids::uuid::from_string("47183823-2574-4bfd-b411-99ed177d3e43");
+    const uuids::uuid test_item_id = uuids::uuid::from_string("57183823-2574-4bfd-b411-99ed177d3e43");
+
+    SECTION("begin launch") {
+        fast.serialize_begin_launch(body, "Test \"Launch\"", time, "", uuids::uuid());
+        REQUIRE(body == serializer.serialize_begin_launch(
+            "Test \"Launch\"",
+            time,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt));
+    }
+
+    SECTION("end launch") {
+        fast.serialize_end_launch(body, time);
+        REQUIRE(body == serializer.serialize_end_launch(time));
+    }
+
+    SECTION("begin test item") {
+        fast.serialize_begin_test_item(body, "Test Test Item", time, report_portal::test_item_type::step, launch_id, "");
+        REQUIRE(body == serializer.serialize_begin_test_item(
+            "Test Test Item",
+            time,
+            report_portal::test_item_type::step,
+            launch_id,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt));
+    }
+
+    SECTION("end test item") {
+        fast.serialize_end_test_item(body, time, launch_id, report_portal::test_item_status::inherit);
+        REQUIRE(body == serializer.serialize_end_test_item(
+            time,
+            launch_id,
+            std::nullopt,
+            std::nullopt,
+            std::nullopt));
+    }
+
+    SECTION("batch of logs") {
+        const std::vector<report_portal::log> logs = {
+            report_portal::log(launch_id, test_item_id, time, report_portal::log_level::trace, "Trace message"),
+            report_portal::log(launch_id, test_item_id, time, report_portal::log_level::error, "Error\nmessage"),
+        };
+
+        fast.begin_batched_logs(body);
+        fast.append_log(body, launch_id, test_item_id, time, report_portal::log_level::trace, "Trace message");
+        fast.append_log(body, launch_id, test_item_id, time, report_portal::log_level::error, "Error\nmessage");
+        fast.end_batched_logs(body);
+        REQUIRE(body == serializer.serialize_batched_logs(logs));
+    }
+}
+
+TEST_CASE("Request serializer optional members", "[request_serializer]")
+{
+    request_serializer fast;
+    std::string body;
+
+    const std::chrono::system_clock::time_point time = from_iso_8601("2020-05-09T22:30:58-0500");
+    const uuids::uuid launch_id = uuids::uuid::from_string("47183823-2574-4bfd-b411-99ed177d3e43");
+
+    fast.serialize_begin_launch(body, "Test Launch", time, "Launch description", launch_id);
+    REQUIRE(body.find(",\"description\":\"Launch description\",\"rerun\":true,\"rerunOf\":\"47183823-2574-4bfd-b411-99ed177d3e43\"}") != std::string::npos);
+
+    fast.serialize_end_test_item(body, time, launch_id, report_portal::test_item_status::failed);
+    REQUIRE(body.find(",\"status\":\"failed\"}") != std::string::npos);
+}
+
+TEST_CASE("Request schemas write the same JSON as the json writer", "[request_schema]")
+{
+    const std::chrono::system_clock::time_point time = from_iso_8601("2020-05-09T22:30:58-0500") + std::chrono::microseconds(42);
+    const uuids::uuid launch_id = uuids::uuid::from_string("47183823-2574-4bfd-b411-99ed177d3e43");
+    const uuids::uuid test_item_id = uuids::uuid::from_string("57183823-2574-4bfd-b411-99ed177d3e43");
+
+    std::string expected;
+    json_writer writer(expected);
+    writer.begin_object();
+    writer.key("launchUuid");
+    writer.value(launch_id);
+    writer.key("time");
+    writer.value(time);
+    writer.key("itemUuid");
+    writer.value(test_item_id);
+    writer.key("message");
+    writer.value("Value of: \"x\"\n");
+    writer.key("level");
+    writer.value("warn");
+    writer.end_object();
+
+    std::string body;
+    reportportal::gtest::log_schema::append(body, launch_id, time, test_item_id, std::string_view("Value of: \"x\"\n"), report_portal::log_level::warn);
+
+    REQUIRE(body == expected);
+}
+
+TEST_CASE("Request schemas splice values between fixed fragments", "[request_schema]")
+{
+    using reportportal::gtest::request_schema;
+    namespace fields = reportportal::gtest::fields;
+
+    std::string body = "[";
+    request_schema<fields::name, fields::type>::append(body, std::string_view("a\tb"), report_portal::test_item_type::suite);
+    body += ",";
+    request_schema<fields::message>::append(body, std::string_view(""));
+
+    REQUIRE(body == "[{\"name\":\"a\\tb\",\"type\":\"suite\"},{\"message\":\"\"}");
+}
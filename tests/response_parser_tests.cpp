@@ -0,0 +1,177 @@
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include <reportportal/rapidjson_serializer.hpp>
+#include <response_parser.hpp>
+
+using reportportal::gtest::parse_response;
+using reportportal::gtest::response_fields;
+
+namespace {
+
+const std::string id_string = "039eda00-b397-4a6b-bab1-b1a9a90376d1";
+
+}
+
+TEST_CASE("Parse begin launch responce", "[response_parser]")
+{
+    const uuids::uuid launch_id = uuids::uuid::from_string(id_string);
+
+    SECTION("With only \"id\" in responce") {
+        std::string begin_launch_responce =
+            "{"
+            "\"id\":\"" + id_string + "\""
+            "}";
+
+        const response_fields fields = parse_response(begin_launch_responce);
+
+        REQUIRE(fields.id.has_value());
+        REQUIRE(*fields.id == launch_id);
+        REQUIRE(fields.number.has_value() == false);
+    }
+
+    SECTION("with optional number in repsonce") {
+        const uint64_t number = 12345;
+        std::string begin_launch_responce =
+            "{"
+            "\"id\":\"" + id_string + "\","
+            "\"number\":" + std::to_string(number) + ""
+            "}";
+
+        const response_fields fields = parse_response(begin_launch_responce);
+
+        REQUIRE(*fields.id == launch_id);
+        REQUIRE(fields.number.has_value());
+        REQUIRE(*fields.number == number);
+    }
+}
+
+TEST_CASE("Parse end launch responce", "[response_parser]")
+{
+    const uuids::uuid launch_id = uuids::uuid::from_string(id_string);
+
+    SECTION("With only \"id\" in responce") {
+        std::string end_launch_responce =
+            "{"
+            "\"id\":\"" + id_string + "\""
+            "}";
+
+        const response_fields fields = parse_response(end_launch_responce);
+
+        REQUIRE(*fields.id == launch_id);
+        REQUIRE(fields.number.has_value() == false);
+        REQUIRE(fields.link.has_value() == false);
+    }
+
+    SECTION("with optional attributes in responce") {
+        const uint64_t number = 12345;
+        const std::string link = "http://localhost:8080/ui/#default_personal/launches/all/12345";
+        std::string end_launch_responce =
+            "{"
+            "\"id\":\"" + id_string + "\","
+            "\"number\":" + std::to_string(number) + ","
+            "\"link\":\"" + link + "\""
+            "}";
+
+        const response_fields fields = parse_response(end_launch_responce);
+
+        REQUIRE(*fields.id == launch_id);
+        REQUIRE(*fields.number == number);
+        REQUIRE(fields.link.has_value());
+        REQUIRE(*fields.link == link);
+    }
+}
+
+TEST_CASE("Parse begin test item responce", "[response_parser]")
+{
+    const uuids::uuid test_item_id = uuids::uuid::from_string(id_string);
+
+    std::string begin_test_item_responce =
+        "{"
+        "\"id\":\"" + id_string + "\""
+        "}";
+
+    const response_fields fields = parse_response(begin_test_item_responce);
+
+    REQUIRE(*fields.id == test_item_id);
+}
+
+TEST_CASE("Parse end test item responce", "[response_parser]")
+{
+    const std::string message = "TestItem with ID = '" + id_string + "' successfully finished.";
+    std::string end_test_item_responce =
+        "{"
+        "\"message\":\"" + message + "\""
+        "}";
+
+    const response_fields fields = parse_response(end_test_item_responce);
+
+    REQUIRE(fields.id.has_value() == false);
+    REQUIRE(fields.message.has_value());
+    REQUIRE(*fields.message == message);
+}
+
+TEST_CASE("Parse responce with other members", "[response_parser]")
+{
+    std::string responce =
+        "{ \"uuid\" : \"ignored\",\n"
+        "  \"attributes\" : [ { \"key\" : \"}\", \"value\" : [1, 2.5e3, -3] } ],\n"
+        "  \"hasStats\" : true, \"parent\" : null,\n"
+        "  \"id\" : \"" + id_string + "\",\n"
+        "  \"number\" : 7 }";
+
+    const response_fields fields = parse_response(responce);
+
+    REQUIRE(*fields.id == uuids::uuid::from_string(id_string));
+    REQUIRE(*fields.number == 7);
+}
+
+TEST_CASE("Parse responce with escaped strings", "[response_parser]")
+{
+    std::string responce = "{\"message\":\"a\\\"b\\\\c\\/d\\n\\u00e9\\u20AC\\ud83d\\ude00\"}";
+
+    const response_fields fields = parse_response(responce);
+
+    REQUIRE(*fields.message == "a\"b\\c/d\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+}
+
+TEST_CASE("Parse malformed responce", "[response_parser]")
+{
+    const std::string responce = GENERATE(
+        std::string(""),
+        std::string("[]"),
+        std::string("{"),
+        std::string("{\"id\""),
+        std::string("{\"id\":\"not a uuid\"}"),
+        std::string("{\"number\":\"12\"}"),
+        std::string("{\"number\":18446744073709551616}"),
+        std::string("{\"message\":\"\\x\"}"),
+        std::string("{\"message\":\"unterminated}"),
+        std::string("{} trailing"));
+
+    std::string body = responce;
+    REQUIRE_THROWS_AS(parse_response(body), std::runtime_error);
+}
+
+TEST_CASE("Parse responce matches rapidjson", "[response_parser]")
+{
+    report_portal::rapidjson_serializer serializer;
+
+    const std::string responce =
+        "{"
+        "\"id\":\"" + id_string + "\","
+        "\"number\":42,"
+        "\"link\":\"http://localhost:8080/ui/#default_personal/launches/all/42\""
+        "}";
+
+    const report_portal::end_launch_responce expected = serializer.deserialize_end_launch_responce(responce);
+
+    std::string body = responce;
+    const response_fields fields = parse_response(body);
+
+    REQUIRE(*fields.id == expected.id());
+    REQUIRE(fields.number == expected.number());
+    REQUIRE(std::string(*fields.link) == *expected.link());
+}
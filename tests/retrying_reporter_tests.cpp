@@ -0,0 +1,306 @@
+#include <utils.h>
+
+#include <cstdio>
+#include <stdexcept>
+
+#include <catch2/catch.hpp>
+#include <reportportal/gtest/journal.hpp>
+#include <reportportal/gtest/retrying_reporter.hpp>
+
+using reportportal::gtest::event;
+using reportportal::gtest::event_type;
+using reportportal::gtest::item_handle;
+using reportportal::gtest::reporter_metrics;
+using reportportal::gtest::retry_policy;
+using reportportal::gtest::retrying_reporter;
+
+namespace {
+
+// Fails the next failures events, and every event while down is set.
+// Events for the item named rejected fail for good.
+class flaky_reporter : public reportportal::gtest::ireporter
+{
+    public:
+        void report(const event& e) override {
+            ++attempts;
+            if (rejected != reportportal::gtest::null_handle && e.item == rejected) {
+                throw std::invalid_argument("Unknown test item handle");
+            }
+            if (down || failures > 0) {
+                --failures;
+                throw std::runtime_error("server unavailable");
+            }
+            ++delivered;
+        }
+
+        void flush() override {}
+
+        int failures = 0;
+        bool down = false;
+        item_handle rejected = reportportal::gtest::null_handle;
+        int attempts = 0;
+        int delivered = 0;
+};
+
+retry_policy without_delay(int attempts)
+{
+    retry_policy policy;
+    policy.attempts = attempts;
+    policy.base_delay = std::chrono::milliseconds(0);
+    policy.max_delay = std::chrono::milliseconds(0);
+    return policy;
+}
+
+}
+
+TEST_CASE("Retrying reporter retries failed events", "[retrying_reporter]")
+{
+    auto flaky = std::make_unique<flaky_reporter>();
+    flaky_reporter& target = *flaky;
+    retrying_reporter reporter(std::move(flaky), without_delay(3));
+
+    SECTION("until delivered") {
+        target.failures = 2;
+        reporter.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle));
+
+        reporter_metrics metrics;
+        reporter.collect(metrics);
+        REQUIRE(target.delivered == 1);
+        REQUIRE(metrics.retries == 2);
+        REQUIRE(metrics.abandoned_events == 0);
+    }
+
+    SECTION("and gives up without throwing") {
+        target.failures = 5;
+        REQUIRE_NOTHROW(reporter.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle)));
+
+        reporter_metrics metrics;
+        reporter.collect(metrics);
+        REQUIRE(target.attempts == 3);
+        REQUIRE(target.delivered == 0);
+        REQUIRE(metrics.retries == 2);
+        REQUIRE(metrics.abandoned_events == 1);
+        REQUIRE_FALSE(reporter.open());
+    }
+
+    SECTION("but not errors that would fail again") {
+        target.rejected = 1;
+        REQUIRE_THROWS_AS(
+            reporter.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle)),
+            std::invalid_argument);
+        REQUIRE(target.attempts == 1);
+    }
+}
+
+TEST_CASE("Retrying reporter skips the events under an abandoned item", "[retrying_reporter]")
+{
+    auto flaky = std::make_unique<flaky_reporter>();
+    flaky_reporter& target = *flaky;
+    retrying_reporter reporter(std::move(flaky), without_delay(3));
+
+    // launch 1 with suites 2 and 5, of which 2 never makes it.
+    reporter.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle));
+    target.failures = 3;
+    reporter.report(make_event(event_type::begin_item, 2, 1));
+    REQUIRE(target.attempts == 4);
+
+    reporter.report(make_event(event_type::begin_item, 3, 2));
+    reporter.report(make_event(event_type::complete_item, 4, 3));
+
+    event logs = make_event(event_type::log, reportportal::gtest::null_handle, reportportal::gtest::null_handle);
+    logs.logs.resize(2);
+    logs.logs[0].item = 3;
+    logs.logs[1].item = 1;
+    reporter.report(logs);
+
+    reporter.report(make_event(event_type::end_item, 3, 2));
+    reporter.report(make_event(event_type::end_item, 2, 1));
+
+    // Only the launch's log entry was attempted.
+    REQUIRE(target.attempts == 5);
+    REQUIRE(target.delivered == 2);
+
+    reporter.report(make_event(event_type::begin_item, 5, 1));
+    reporter.report(make_event(event_type::end_item, 5, 1));
+    REQUIRE(target.attempts == 7);
+    REQUIRE(target.delivered == 4);
+
+    reporter_metrics metrics;
+    reporter.collect(metrics);
+    REQUIRE(metrics.retries == 2);
+    REQUIRE(metrics.abandoned_events == 5);
+}
+
+TEST_CASE("Retrying reporter falls back to a journal once the server is down", "[retrying_reporter]")
+{
+    const std::string fallback_path = "retrying_reporter_tests.rpj";
+    std::remove(fallback_path.c_str());
+
+    auto flaky = std::make_unique<flaky_reporter>();
+    flaky_reporter& target = *flaky;
+
+    retry_policy policy = without_delay(2);
+    policy.breaker_threshold = 2;
+    policy.fallback_path = fallback_path;
+
+    {
+        retrying_reporter reporter(std::move(flaky), policy);
+
+        // launch 1, suite 2 with tests 3 and 4, of which 4 never makes it.
+        reporter.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle));
+        reporter.report(make_event(event_type::begin_item, 2, 1));
+        reporter.report(make_event(event_type::begin_item, 3, 2));
+        reporter.report(make_event(event_type::end_item, 3, 2));
+
+        target.down = true;
+        reporter.report(make_event(event_type::complete_item, 4, 2));
+        REQUIRE_FALSE(reporter.open());
+        reporter.report(make_event(event_type::end_item, 2, 1));
+        REQUIRE(reporter.open());
+
+        const int attempts = target.attempts;
+        reporter.report(make_event(event_type::end_launch, 1, reportportal::gtest::null_handle));
+        reporter.flush();
+        REQUIRE(target.attempts == attempts);
+
+        reporter_metrics metrics;
+        reporter.collect(metrics);
+        // Test 4 failed before the breaker opened and the end of 2 opened it.
+        REQUIRE(metrics.abandoned_events == 1);
+        REQUIRE(metrics.fallback_events == 4);
+    }
+
+    // The journal recreates the launch and the items still running.
+    recording_reporter recorded;
+    REQUIRE(reportportal::gtest::replay_journal(fallback_path, recorded) == 4);
+
+    const std::vector<std::pair<event_type, item_handle> > expected = {
+        {event_type::begin_launch, 1},
+        {event_type::begin_item, 2},
+        {event_type::end_item, 2},
+        {event_type::end_launch, 1}};
+    REQUIRE(recorded.events.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(recorded.events[i].type == expected[i].first);
+        REQUIRE(recorded.events[i].item == expected[i].second);
+    }
+
+    std::remove(fallback_path.c_str());
+}
+
+TEST_CASE("Retrying reporter journals an item whose begin failed", "[retrying_reporter]")
+{
+    const std::string fallback_path = "retrying_reporter_tests.rpj";
+    std::remove(fallback_path.c_str());
+
+    auto flaky = std::make_unique<flaky_reporter>();
+    flaky_reporter& target = *flaky;
+
+    retry_policy policy = without_delay(2);
+    policy.breaker_threshold = 5;
+    policy.fallback_path = fallback_path;
+
+    {
+        retrying_reporter reporter(std::move(flaky), policy);
+
+        // launch 1, suite 2 with test 3, which never makes it to the server.
+        reporter.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle));
+        reporter.report(make_event(event_type::begin_item, 2, 1));
+
+        target.failures = 2;
+        reporter.report(make_event(event_type::begin_item, 3, 2));
+        REQUIRE(reporter.open());
+
+        reporter.report(make_event(event_type::end_item, 3, 2));
+        reporter.report(make_event(event_type::end_item, 2, 1));
+        reporter.report(make_event(event_type::end_launch, 1, reportportal::gtest::null_handle));
+        REQUIRE(target.attempts == 4);
+    }
+
+    recording_reporter recorded;
+    REQUIRE(reportportal::gtest::replay_journal(fallback_path, recorded) == 6);
+
+    const std::vector<std::pair<event_type, item_handle> > expected = {
+        {event_type::begin_launch, 1},
+        {event_type::begin_item, 2},
+        {event_type::begin_item, 3},
+        {event_type::end_item, 3},
+        {event_type::end_item, 2},
+        {event_type::end_launch, 1}};
+    REQUIRE(recorded.events.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(recorded.events[i].type == expected[i].first);
+        REQUIRE(recorded.events[i].item == expected[i].second);
+    }
+
+    std::remove(fallback_path.c_str());
+}
+
+TEST_CASE("Retrying reporter journals the whole run when the server is down from the start", "[retrying_reporter]")
+{
+    const std::string fallback_path = "retrying_reporter_tests.rpj";
+    std::remove(fallback_path.c_str());
+
+    auto flaky = std::make_unique<flaky_reporter>();
+    flaky_reporter& target = *flaky;
+    target.down = true;
+
+    retry_policy policy = without_delay(3);
+    policy.breaker_threshold = 5;
+    policy.fallback_path = fallback_path;
+
+    event logs = make_event(event_type::log, reportportal::gtest::null_handle);
+    logs.logs.resize(1);
+    logs.logs[0].item = 3;
+
+    {
+        retrying_reporter reporter(std::move(flaky), policy);
+
+        reporter.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle));
+        REQUIRE(reporter.open());
+
+        reporter.report(make_event(event_type::begin_item, 2, 1));
+        reporter.report(make_event(event_type::begin_item, 3, 2));
+        reporter.report(logs);
+        reporter.report(make_event(event_type::end_item, 3, 2));
+        reporter.report(make_event(event_type::complete_item, 4, 2));
+        reporter.report(make_event(event_type::end_item, 2, 1));
+        reporter.report(make_event(event_type::end_launch, 1, reportportal::gtest::null_handle));
+        reporter.flush();
+
+        // Only the launch's begin was tried.
+        REQUIRE(target.attempts == 3);
+
+        reporter_metrics metrics;
+        reporter.collect(metrics);
+        REQUIRE(metrics.abandoned_events == 0);
+        REQUIRE(metrics.fallback_events == 8);
+    }
+
+    recording_reporter recorded;
+    REQUIRE(reportportal::gtest::replay_journal(fallback_path, recorded) == 8);
+
+    const std::vector<std::pair<event_type, item_handle> > expected = {
+        {event_type::begin_launch, 1},
+        {event_type::begin_item, 2},
+        {event_type::begin_item, 3},
+        {event_type::log, reportportal::gtest::null_handle},
+        {event_type::end_item, 3},
+        {event_type::complete_item, 4},
+        {event_type::end_item, 2},
+        {event_type::end_launch, 1}};
+    REQUIRE(recorded.events.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(recorded.events[i].type == expected[i].first);
+        REQUIRE(recorded.events[i].item == expected[i].second);
+    }
+    REQUIRE(recorded.events[3].logs.size() == 1);
+
+    std::remove(fallback_path.c_str());
+}
+
+TEST_CASE("Retrying reporter construction", "[retrying_reporter]")
+{
+    REQUIRE_THROWS_AS(retrying_reporter(nullptr, retry_policy()), std::invalid_argument);
+    REQUIRE_THROWS_AS(retrying_reporter(std::make_unique<recording_reporter>(), without_delay(0)), std::invalid_argument);
+}
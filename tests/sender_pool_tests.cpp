@@ -0,0 +1,220 @@
+#include <utils.h>
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include <catch2/catch.hpp>
+#include <reportportal/gtest/sender_pool.hpp>
+
+using reportportal::gtest::event;
+using reportportal::gtest::event_type;
+using reportportal::gtest::item_handle;
+using reportportal::gtest::log_entry;
+using reportportal::gtest::sender_pool;
+
+namespace {
+
+// Records events from several threads and checks that every item is reported
+// in order: its parent has begun, logs arrive while it runs and it has no
+// running children when it ends.
+class ordering_reporter : public reportportal::gtest::ireporter
+{
+    public:
+        void report(const event& e) override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++events;
+            threads.insert(std::this_thread::get_id());
+
+            switch (e.type) {
+                case event_type::begin_launch:
+                    _running[e.item] = reportportal::gtest::null_handle;
+                    break;
+                case event_type::begin_item:
+                    check(_running.count(e.parent) == 1);
+                    _running[e.item] = e.parent;
+                    break;
+                case event_type::end_item:
+                case event_type::end_launch:
+                case event_type::leave_launch:
+                    check(_running.count(e.item) == 1);
+                    for (const auto& running : _running) {
+                        check(running.second != e.item);
+                    }
+                    _running.erase(e.item);
+                    break;
+                case event_type::log:
+                    for (const log_entry& entry : e.logs) {
+                        check(_running.count(entry.item) == 1);
+                        ++logs;
+                    }
+                    break;
+                case event_type::complete_item:
+                    check(_running.count(e.parent) == 1);
+                    logs += static_cast<int>(e.logs.size());
+                    break;
+            }
+        }
+
+        void flush() override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++flush_count;
+        }
+
+        int events = 0;
+        int logs = 0;
+        int flush_count = 0;
+        int out_of_order = 0;
+        std::set<std::thread::id> threads;
+
+    private:
+        void check(bool in_order) {
+            if (!in_order) {
+                ++out_of_order;
+            }
+        }
+
+        std::mutex _mutex;
+        std::map<item_handle, item_handle> _running;
+};
+
+event make_log(std::initializer_list<item_handle> items)
+{
+    event e;
+    e.type = event_type::log;
+    for (item_handle item : items) {
+        log_entry entry;
+        entry.item = item;
+        entry.message = "failure";
+        e.logs.push_back(entry);
+    }
+    return e;
+}
+
+}
+
+TEST_CASE("Sender pool keeps every item in order", "[sender_pool]")
+{
+    auto recorder = std::make_unique<ordering_reporter>();
+    ordering_reporter& recorded = *recorder;
+    sender_pool pool(std::move(recorder), 4, 8);
+
+    // launch 1, top level suite 2, suites and their tests below it.
+    pool.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle));
+    pool.report(make_event(event_type::begin_item, 2, 1));
+
+    const int suites = 20;
+    const int tests = 10;
+    item_handle next = 3;
+    for (int suite = 0; suite < suites; ++suite) {
+        const item_handle suite_item = next++;
+        pool.report(make_event(event_type::begin_item, suite_item, 2));
+        for (int test = 0; test < tests; ++test) {
+            const item_handle test_item = next++;
+            pool.report(make_event(event_type::begin_item, test_item, suite_item));
+            pool.report(make_log({test_item, suite_item, 2}));
+            pool.report(make_event(event_type::end_item, test_item, suite_item));
+        }
+        pool.report(make_event(event_type::end_item, suite_item, 2));
+    }
+
+    pool.report(make_event(event_type::end_item, 2, 1));
+    pool.report(make_event(event_type::end_launch, 1, reportportal::gtest::null_handle));
+    pool.flush();
+
+    REQUIRE(pool.pending() == 0);
+    REQUIRE(recorded.out_of_order == 0);
+    REQUIRE(recorded.flush_count == 1);
+    REQUIRE(recorded.logs == suites * tests * 3);
+    REQUIRE(recorded.events == 4 + suites * (2 + tests * 2) + suites * tests * 2);
+}
+
+TEST_CASE("Sender pool keeps completed items with their suite", "[sender_pool]")
+{
+    auto recorder = std::make_unique<ordering_reporter>();
+    ordering_reporter& recorded = *recorder;
+    sender_pool pool(std::move(recorder), 4, 8);
+
+    pool.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle));
+    pool.report(make_event(event_type::begin_item, 2, 1));
+
+    const int suites = 20;
+    const int tests = 10;
+    item_handle next = 3;
+    for (int suite = 0; suite < suites; ++suite) {
+        const item_handle suite_item = next++;
+        pool.report(make_event(event_type::begin_item, suite_item, 2));
+        for (int test = 0; test < tests; ++test) {
+            const item_handle test_item = next++;
+            event completed = make_log({test_item});
+            completed.type = event_type::complete_item;
+            completed.item = test_item;
+            completed.parent = suite_item;
+            pool.report(completed);
+        }
+        pool.report(make_event(event_type::end_item, suite_item, 2));
+    }
+
+    pool.report(make_event(event_type::end_item, 2, 1));
+    pool.report(make_event(event_type::end_launch, 1, reportportal::gtest::null_handle));
+    pool.flush();
+
+    REQUIRE(recorded.out_of_order == 0);
+    REQUIRE(recorded.logs == suites * tests);
+    REQUIRE(recorded.events == 4 + suites * (2 + tests));
+
+    // The peak is that of the fullest lane, never more than one lane holds.
+    reportportal::gtest::reporter_metrics metrics;
+    pool.collect(metrics);
+    REQUIRE(metrics.max_queued >= 1);
+    REQUIRE(metrics.max_queued <= 8);
+}
+
+TEST_CASE("Sender pool rethrows errors when flushed", "[sender_pool]")
+{
+    sender_pool pool(std::make_unique<throwing_reporter>(3), 2, 8);
+
+    pool.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle));
+    pool.report(make_event(event_type::begin_item, 2, 1));
+    pool.report(make_event(event_type::begin_item, 3, 2));
+
+    REQUIRE_THROWS_AS(pool.flush(), std::runtime_error);
+    REQUIRE_NOTHROW(pool.flush());
+}
+
+TEST_CASE("Sender pool keeps its lanes within the memory budget", "[sender_pool]")
+{
+    auto gate = std::make_unique<gated_reporter>();
+    gated_reporter& gated = *gate;
+    gated.open();
+
+    // Every lane's share of the budget is smaller than any one event.
+    sender_pool pool(std::move(gate), 2, 8, 2, reportportal::gtest::overflow_policy::drop_logs);
+
+    pool.report(make_event(event_type::begin_launch, 1, reportportal::gtest::null_handle));
+    pool.report(make_event(event_type::begin_item, 2, 1));
+
+    // Suite 3 holds up its lane, so its logs do not fit behind it.
+    gated.close();
+    pool.report(make_event(event_type::begin_item, 3, 2));
+    for (int i = 0; i < 5; ++i) {
+        pool.report(make_log({3}));
+    }
+
+    gated.open();
+    pool.report(make_event(event_type::end_item, 3, 2));
+    pool.flush();
+
+    reportportal::gtest::reporter_metrics metrics;
+    pool.collect(metrics);
+    REQUIRE(metrics.dropped_logs == 5);
+    REQUIRE(gated.events.size() == 4);
+}
+
+TEST_CASE("Sender pool checks its arguments", "[sender_pool]")
+{
+    REQUIRE_THROWS_AS(sender_pool(nullptr, 2, 8), std::invalid_argument);
+    REQUIRE_THROWS_AS(sender_pool(std::make_unique<recording_reporter>(), 0, 8), std::invalid_argument);
+}
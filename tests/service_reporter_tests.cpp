@@ -0,0 +1,191 @@
+#include <utils.h>
+
+#include <catch2/catch.hpp>
+#include <fakeit.hpp>
+#include <reportportal/gtest/service_reporter.hpp>
+
+using namespace fakeit;
+using reportportal::gtest::event;
+using reportportal::gtest::event_type;
+
+TEST_CASE("Service reporter without a launch", "[service_reporter]")
+{
+    Mock<report_portal::iservice> service_mock;
+    reportportal::gtest::service_reporter reporter(service_mock.get());
+
+    event item;
+    item.type = event_type::begin_item;
+    item.item = 2;
+    item.parent = 1;
+    REQUIRE_THROWS_AS(reporter.report(item), std::logic_error);
+
+    event end;
+    end.type = event_type::end_launch;
+    end.item = 1;
+    REQUIRE_THROWS_AS(reporter.report(end), std::logic_error);
+}
+
+TEST_CASE("Service reporter resolves handles", "[service_reporter]")
+{
+    Mock<report_portal::iservice> service_mock;
+    reportportal::gtest::service_reporter reporter(service_mock.get());
+
+    uuids::uuid generated_launch_id = uuids::uuid::from_string("47183823-2574-4bfd-b411-99ed177d3e43");
+    When(Method(service_mock, begin_launch)
+        .Using(
+            _,
+            _,
+            _,
+            uuids::uuid(),
+            _,
+            _,
+            _,
+            _))
+        .Return(report_portal::begin_launch_responce(generated_launch_id));
+
+    event launch;
+    launch.type = event_type::begin_launch;
+    launch.item = 1;
+    launch.time = from_iso_8601("2020-05-09T22:30:58-0500");
+    launch.name = "Test Launch";
+    reporter.report(launch);
+
+    uuids::uuid generated_test_item_id = uuids::uuid::from_string("47183823-2574-4bfd-c411-99ed177d3e44");
+    When(Method(service_mock, begin_test_item)
+        .Using(
+            _,
+            _,
+            _,
+            _,
+            _,
+            _,
+            _,
+            _,
+            _,
+            _,
+            _,
+            _))
+        .Return(report_portal::begin_test_item_responce(generated_test_item_id));
+
+    event suite;
+    suite.type = event_type::begin_item;
+    suite.item = 2;
+    suite.parent = 1;
+    suite.time = from_iso_8601("2020-05-09T22:35:58-0500");
+    suite.name = "Test Suite";
+    reporter.report(suite);
+
+    SECTION("unknown handles are rejected") {
+        event unknown;
+        unknown.type = event_type::end_item;
+        unknown.item = 42;
+        REQUIRE_THROWS_AS(reporter.report(unknown), std::invalid_argument);
+    }
+
+    SECTION("abandoning reports what is running") {
+        recording_reporter overflow;
+        REQUIRE(reporter.abandon(overflow, std::chrono::steady_clock::now()) == 0);
+
+        REQUIRE(overflow.events.size() == 2);
+        REQUIRE(overflow.events[0].type == event_type::begin_launch);
+        REQUIRE(overflow.events[0].name == "Test Launch");
+        REQUIRE(overflow.events[1].type == event_type::begin_item);
+        REQUIRE(overflow.events[1].item == 2);
+        REQUIRE(overflow.events[1].parent == 1);
+        REQUIRE(overflow.events[1].name == "Test Suite");
+    }
+
+    SECTION("completing an item begins and ends it") {
+        When(Method(service_mock, end_test_item)
+            .Using(
+                _,
+                _,
+                _,
+                _,
+                _))
+            .Return(report_portal::end_test_item_responce("finished"));
+
+        event test;
+        test.type = event_type::complete_item;
+        test.item = 3;
+        test.parent = 2;
+        test.time = from_iso_8601("2020-05-09T22:36:58-0500");
+        test.end_time = from_iso_8601("2020-05-09T22:37:58-0500");
+        test.name = "Test";
+        test.item_type = report_portal::test_item_type::step;
+        test.status = report_portal::test_item_status::passed;
+        reporter.report(test);
+
+        Verify(Method(service_mock, begin_test_item)).Exactly(2);
+        Verify(Method(service_mock, end_test_item)
+            .Using(
+                generated_test_item_id,
+                _,
+                test.end_time,
+                report_portal::test_item_status::passed,
+                std::nullopt))
+            .Exactly(1);
+
+        reportportal::gtest::reporter_metrics metrics;
+        reporter.collect(metrics);
+        REQUIRE(metrics.requests == 4);
+    }
+
+    SECTION("ending the item and launch") {
+        const std::string responce_message = "TestItem with ID = '47183823-2574-4bfd-c411-99ed177d3e44' successfully finished.";
+        When(Method(service_mock, end_test_item)
+            .Using(
+                _,
+                _,
+                _,
+                _,
+                _))
+            .Return(report_portal::end_test_item_responce(responce_message));
+
+        event suite_end;
+        suite_end.type = event_type::end_item;
+        suite_end.item = 2;
+        suite_end.time = from_iso_8601("2020-05-09T23:35:58-0500");
+        suite_end.status = report_portal::test_item_status::passed;
+        reporter.report(suite_end);
+
+        When(Method(service_mock, end_launch)
+            .Using(
+                _,
+                _))
+            .Return(report_portal::end_launch_responce(generated_launch_id));
+
+        event launch_end;
+        launch_end.type = event_type::end_launch;
+        launch_end.item = 1;
+        launch_end.time = from_iso_8601("2020-05-09T23:40:58-0500");
+        reporter.report(launch_end);
+
+        Verify(Method(service_mock, end_test_item)
+            .Using(
+                generated_test_item_id,
+                _,
+                suite_end.time,
+                report_portal::test_item_status::passed,
+                std::nullopt))
+            .Exactly(1);
+
+        Verify(Method(service_mock, end_launch)
+            .Using(
+                generated_launch_id,
+                launch_end.time))
+            .Exactly(1);
+    }
+
+    Verify(Method(service_mock, begin_launch)
+        .Using(
+            "Test Launch",
+            launch.time,
+            _,
+            uuids::uuid(),
+            _,
+            _,
+            _,
+            _))
+        .Exactly(1);
+}
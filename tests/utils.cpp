@@ -1,5 +1,7 @@
 #include <utils.h>
 
+#include <stdexcept>
+
 
 static std::string to_iso_8601(const std::chrono::system_clock::time_point& time)
 {
@@ -37,6 +39,72 @@ std::chrono::system_clock::time_point from_iso_8601(const std::string& time)
     return std::chrono::system_clock::from_time_t(std::mktime(&local_tm));
 }
 
+void recording_reporter::report(const reportportal::gtest::event& e)
+{
+    events.push_back(e);
+}
+
+void recording_reporter::flush()
+{
+    ++flush_count;
+}
+
+throwing_reporter::throwing_reporter(reportportal::gtest::item_handle first_failing)
+  : _first_failing(first_failing)
+{
+}
+
+void throwing_reporter::report(const reportportal::gtest::event& e)
+{
+    if (e.item >= _first_failing) {
+        throw std::runtime_error("server unavailable");
+    }
+}
+
+void throwing_reporter::flush()
+{
+}
+
+void gated_reporter::report(const reportportal::gtest::event& e)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _opened.wait(lock, [this] { return _open; });
+    events.push_back(e);
+}
+
+void gated_reporter::flush()
+{
+}
+
+void gated_reporter::open()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _open = true;
+    }
+    _opened.notify_all();
+}
+
+void gated_reporter::close()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _open = false;
+}
+
+reportportal::gtest::event make_event(
+    reportportal::gtest::event_type type,
+    reportportal::gtest::item_handle item,
+    reportportal::gtest::item_handle parent,
+    const std::string& name)
+{
+    reportportal::gtest::event e;
+    e.type = type;
+    e.item = item;
+    e.parent = parent;
+    e.name = name;
+    return e;
+}
+
 namespace std {
 std::ostream& operator<<(std::ostream& output, const std::optional<uuids::uuid>& value) {
     if (value) {
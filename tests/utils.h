@@ -1,16 +1,70 @@
 #pragma once
 
 #include <chrono>
+#include <condition_variable>
 #include <ctime>
 #include <iomanip>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <optional>
+#include <vector>
 #include <uuid.h>
 #include <reportportal/ijson_serializer.hpp>
+#include <reportportal/gtest/ireporter.hpp>
 
 std::chrono::system_clock::time_point from_iso_8601(const std::string& time);
 
+// Keeps a copy of every event it is given so tests can inspect them.
+class recording_reporter : public reportportal::gtest::ireporter
+{
+    public:
+        void report(const reportportal::gtest::event& e) override;
+        void flush() override;
+
+        std::vector<reportportal::gtest::event> events;
+        int flush_count = 0;
+};
+
+// Fails every event for an item at or after first_failing, as a server that
+// is down would.
+class throwing_reporter : public reportportal::gtest::ireporter
+{
+    public:
+        explicit throwing_reporter(reportportal::gtest::item_handle first_failing = reportportal::gtest::null_handle);
+
+        void report(const reportportal::gtest::event& e) override;
+        void flush() override;
+
+    private:
+        reportportal::gtest::item_handle _first_failing;
+};
+
+// Holds the thread reporting to it in report until opened, so a queue in
+// front of it fills up.
+class gated_reporter : public reportportal::gtest::ireporter
+{
+    public:
+        void report(const reportportal::gtest::event& e) override;
+        void flush() override;
+
+        void open();
+        void close();
+
+        std::vector<reportportal::gtest::event> events;
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _opened;
+        bool _open = false;
+};
+
+reportportal::gtest::event make_event(
+    reportportal::gtest::event_type type,
+    reportportal::gtest::item_handle item,
+    reportportal::gtest::item_handle parent = reportportal::gtest::null_handle,
+    const std::string& name = "");
+
 namespace std {
 std::ostream& operator<<(std::ostream& output, const std::optional<uuids::uuid>& value);
 std::ostream& operator<<(std::ostream& output, const std::optional<std::string>& value);